@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Scripted frame-time benchmark: runs the real panels on SDL's offscreen (or
+// dummy) video driver, replays an interaction trace and reports per-frame CPU
+// time percentiles (p50/p99/max) for each phase and each panel.
+//   main --bench-frames FILE [TRACE] [-o PATH]
+// TRACE has one command per line ('#' starts a comment):
+//   frames N              draw N frames without input
+//   scroll NOTCHES N      mouse wheel NOTCHES per frame (negative: up) for N frames
+//   jump FRACTION         move the list to FRACTION (0..1) of its height
+//   expand N | collapse N open/close the first N visible documents
+//   search TEXT           type TEXT and press Search
+//   wait_search           draw frames until the search completes
+// Without TRACE a built-in trace scrolls, expands documents and searches.
+// The report is JSON on stdout (or PATH), with a summary table on stderr.
+// `args` excludes the program name and "--bench-frames"; returns the exit code.
+int run_frame_bench(const std::vector<std::string>& args);
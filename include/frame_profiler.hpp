@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Stages of one UI frame, in the order the main loop runs them
+enum class FramePhase : uint8_t {
+    Events,    // Event polling (not the idle wait)
+    NewFrame,  // Backend and ImGui frame setup
+    Panels,    // PanelManager::draw_all()
+    Scheduler, // Incremental jobs
+    Render,    // ImGui::Render() and the unchanged-frame check
+    Backend,   // Draw-data submission to the renderer
+    Present,   // SDL_RenderPresent(), including any vsync wait
+    Count,
+};
+
+constexpr size_t FRAME_PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+
+const char* frame_phase_name(FramePhase phase);
+
+// Ring buffer of per-phase and per-panel CPU times for the last HISTORY frames.
+// Disabled by default: begin_frame()/mark()/end_frame() then return after one
+// branch and PanelManager::draw_all() reads no clocks.
+// Not thread-safe: owned by the UI thread.
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t HISTORY = 240;   // About 4 s at 60 Hz
+    static constexpr size_t MAX_PANELS = 16; // Panels past this are not recorded
+
+    struct Frame {
+        std::array<float, FRAME_PHASE_COUNT> phase_ms{};
+        std::array<float, MAX_PANELS> panel_ms{}; // PanelManager registration order
+        float total_ms = 0.0F;
+    };
+
+    static FrameProfiler& instance();
+
+    bool enabled() const { return enabled_; }
+    // Also switches PanelManager's per-panel timing; enabling clears the history
+    void set_enabled(bool enabled);
+
+    // Starts timing a frame (call once the loop stops waiting for events)
+    void begin_frame() {
+        if (!enabled_) {
+            return;
+        }
+        in_frame_ = true;
+        current_ = {};
+        frame_start_ = Clock::now();
+        phase_start_ = frame_start_;
+    }
+
+    // Ends `phase`: it gets the time since the previous mark() or begin_frame()
+    void mark(FramePhase phase) {
+        if (!in_frame_) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        current_.phase_ms[static_cast<size_t>(phase)] += to_ms(now - phase_start_);
+        phase_start_ = now;
+    }
+
+    // Stores the frame with the panel timings of its draw_all()
+    void end_frame();
+
+    // Stored frames, at most HISTORY
+    size_t frame_count() const { return count_; }
+    // `age` 0 is the newest frame; requires age < frame_count()
+    const Frame& frame(size_t age) const { return frames_[(next_ + HISTORY - 1 - age) % HISTORY]; }
+
+private:
+    FrameProfiler() = default;
+
+    static float to_ms(Clock::duration duration) {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+
+    bool enabled_ = false;
+    bool in_frame_ = false; // begin_frame() ran while enabled
+    Frame current_;
+    Clock::time_point frame_start_;
+    Clock::time_point phase_start_;
+    std::array<Frame, HISTORY> frames_{};
+    size_t next_ = 0;
+    size_t count_ = 0;
+};
+
+FrameProfiler& get_frame_profiler();
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Command-line mode that runs the loader and search engine without SDL/ImGui:
+//   main --headless index  FILE              build and save the sidecar index
+//   main --headless count  FILE TEXT         number of matching documents
+//   main --headless grep   FILE TEXT         doc:offset:context for every match
+//   main --headless filter FILE TEXT         matching documents as NDJSON
+//   main --headless export FILE [TEXT]       pretty-printed documents (all or matching)
+// `-o PATH` writes to a file instead of stdout. Timings and throughput go to stderr.
+// `args` excludes the program name and "--headless"; returns the exit code.
+int run_headless(const std::vector<std::string>& args);
@@ -1,5 +1,11 @@
 #pragma once
 
+#include "utils/allocation_counter.hpp"
+#include "utils/frame_arena.hpp"
+#include "utils/trace.hpp"
+
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <utility>
 #include <vector>
@@ -7,6 +13,7 @@
 // Singleton that manages all UI panels.
 // Panels register themselves at static initialization time,
 // then draw_all() is called each frame to render them.
+// Also owns the per-frame arena panels use for scratch data.
 class PanelManager {
 public:
     // Returns the single global instance (lazy initialization)
@@ -15,30 +22,75 @@ public:
         return manager;
     }
 
+    // CPU time one panel spent in the last draw_all()
+    struct PanelTiming {
+        const char* name;
+        double seconds;
+    };
+
     // Register a panel's draw function
-    void add(std::function<void()> draw_fn) { panels_.push_back(std::move(draw_fn)); }
+    void add(const char* name, std::function<void()> draw_fn) {
+        panels_.push_back(std::move(draw_fn));
+        timings_.push_back({name, 0.0});
+    }
+
+    // Starts a frame: releases last frame's scratch data (call right after ImGui::NewFrame())
+    void begin_frame() {
+        uint64_t allocations = thread_heap_allocations();
+        last_frame_allocations_ = allocations - frame_start_allocations_;
+        frame_start_allocations_ = allocations;
+        frame_arena_.reset();
+    }
+
+    // Scratch memory valid until the next begin_frame()
+    FrameArena& frame_arena() { return frame_arena_; }
+
+    // Heap allocations the UI thread made during the previous frame (0 in steady state)
+    uint64_t last_frame_allocations() const { return last_frame_allocations_; }
 
     // Call all registered panel draw functions (call once per frame)
-    void draw_all() const {
-        for (const auto& panel : panels_) {
-            panel();
+    void draw_all() {
+        if (!timing_enabled_) {
+            for (size_t i = 0; i < panels_.size(); i++) {
+                TraceScope trace(timings_[i].name);
+                panels_[i]();
+            }
+            return;
+        }
+        for (size_t i = 0; i < panels_.size(); i++) {
+            TraceScope trace(timings_[i].name);
+            auto start = std::chrono::steady_clock::now();
+            panels_[i]();
+            timings_[i].seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         }
     }
 
+    // Per-panel timing is off by default; when off, draw_all() adds no clock reads
+    void set_timing_enabled(bool enabled) { timing_enabled_ = enabled; }
+    // In registration order; valid while timing is enabled
+    const std::vector<PanelTiming>& last_frame_timings() const { return timings_; }
+
 private:
     PanelManager() = default;
     std::vector<std::function<void()>> panels_;
+    std::vector<PanelTiming> timings_;
+    bool timing_enabled_ = false;
+    FrameArena frame_arena_;
+    uint64_t frame_start_allocations_ = 0;
+    uint64_t last_frame_allocations_ = 0;
 };
 
 // Helper struct for static auto-registration.
 // When constructed, it registers the given function with PanelManager.
 struct PanelRegistrar {
-    explicit PanelRegistrar(std::function<void()> draw_fn) {
-        PanelManager::instance().add(std::move(draw_fn));
+    PanelRegistrar(const char* name, std::function<void()> draw_fn) {
+        PanelManager::instance().add(name, std::move(draw_fn));
     }
 };
 
 // Macro for auto-registering a panel draw function.
 // Usage: REGISTER_PANEL(MyDrawFunction);
 // This creates a static PanelRegistrar that runs at program startup.
-#define REGISTER_PANEL(func) static PanelRegistrar _registrar_##func(func)
+// The function name doubles as the panel's name in timings.
+#define REGISTER_PANEL(func) static PanelRegistrar _registrar_##func(#func, func)
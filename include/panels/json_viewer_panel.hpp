@@ -1,3 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <string>
+
 void draw_json_viewer_panel();
+
+// Scripted interaction, used by the frame benchmark to replay a trace.
+// Each request takes effect on the next frame the viewer draws.
+void script_viewer_search(const std::string& text);  // Type `text` and press Search
+void script_viewer_set_open(size_t rows, bool open); // Open/close the first visible rows
+void script_viewer_jump(double fraction);            // Scroll to a fraction of the list
+bool viewer_search_in_progress();
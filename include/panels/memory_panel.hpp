@@ -0,0 +1,5 @@
+#pragma once
+
+// Memory accounting overlay: bytes held by each large structure next to the
+// process RSS. F5 toggles it.
+void draw_memory_panel();
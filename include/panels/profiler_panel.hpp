@@ -0,0 +1,6 @@
+#pragma once
+
+// Frame profiler overlay: frame-time graph plus per-phase and per-panel
+// breakdown of recent frames. F3 toggles it (and the profiler) on and off.
+// F4 starts trace recording, then writes the trace on each later press.
+void draw_profiler_panel();
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of global operator new calls made by the calling thread so far.
+// The replacement operators live in allocation_counter.cpp; frame stats diff
+// this around a frame to check that steady-state frames stay off the heap.
+uint64_t thread_heap_allocations();
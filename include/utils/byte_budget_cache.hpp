@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// How a cache access should be treated by the admission policy
+enum class CacheHint : uint8_t {
+    Normal, // Interactive access: counted and admitted
+    Scan,   // One-pass traffic (search, export): bypasses the cache entirely
+};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t rejections = 0; // Candidates the admission filter kept out
+    size_t bytes = 0;
+    size_t entries = 0;
+    size_t budget_bytes = 0;
+};
+
+// Byte-bounded, scan-resistant cache (W-TinyLFU).
+// New entries land in a small LRU window. When the window overflows, its
+// oldest entry competes with the main region's eviction victim and is only
+// admitted if a count-min sketch says it is used more often. The main region
+// is a segmented LRU (probation + protected), so a burst of one-off accesses
+// cannot flush the entries the user keeps coming back to.
+// Not thread-safe: callers lock around it.
+template <typename Key, typename Value>
+class ByteBudgetCache {
+public:
+    explicit ByteBudgetCache(size_t budget_bytes) { set_budget(budget_bytes); }
+
+    void set_budget(size_t budget_bytes) {
+        budget_bytes_ = budget_bytes;
+        window_budget_ = std::max<size_t>(budget_bytes / 100, 1);
+        main_budget_ = budget_bytes - std::min(window_budget_, budget_bytes);
+        protected_budget_ = main_budget_ / 5 * 4;
+        evict_overflow();
+    }
+
+    // Returns the cached value or nullptr. The pointer is valid until the next insert/clear.
+    // A Scan lookup leaves recency, frequency and hit/miss stats untouched.
+    const Value* find(const Key& key, CacheHint hint = CacheHint::Normal) {
+        auto lookup_iter = lookup_.find(key);
+        if (hint == CacheHint::Scan) {
+            return lookup_iter != lookup_.end() ? &lookup_iter->second.entry->value : nullptr;
+        }
+        sketch_.increment(hash_(key));
+        if (lookup_iter == lookup_.end()) {
+            stats_.misses++;
+            return nullptr;
+        }
+        stats_.hits++;
+        touch(lookup_iter->second);
+        return &lookup_iter->second.entry->value;
+    }
+
+    // Inserts (or replaces) a value costing `bytes` of budget
+    void insert(const Key& key, Value value, size_t bytes, CacheHint hint = CacheHint::Normal) {
+        if (hint == CacheHint::Scan || bytes > main_budget_) {
+            return;
+        }
+        erase(key);
+        sketch_.increment(hash_(key));
+
+        window_.push_front({key, std::move(value), bytes});
+        lookup_[key] = {Segment::Window, window_.begin()};
+        segment_bytes(Segment::Window) += bytes;
+        evict_overflow();
+    }
+
+    void erase(const Key& key) {
+        auto lookup_iter = lookup_.find(key);
+        if (lookup_iter == lookup_.end()) {
+            return;
+        }
+        Location location = lookup_iter->second;
+        segment_bytes(location.segment) -= location.entry->bytes;
+        segment_list(location.segment).erase(location.entry);
+        lookup_.erase(lookup_iter);
+    }
+
+    void clear() {
+        window_.clear();
+        probation_.clear();
+        protected_.clear();
+        lookup_.clear();
+        window_bytes_ = probation_bytes_ = protected_bytes_ = 0;
+        sketch_.clear();
+    }
+
+    CacheStats stats() const {
+        CacheStats stats = stats_;
+        stats.bytes = window_bytes_ + probation_bytes_ + protected_bytes_;
+        stats.entries = lookup_.size();
+        stats.budget_bytes = budget_bytes_;
+        return stats;
+    }
+
+private:
+    enum class Segment : uint8_t { Window, Probation, Protected };
+
+    struct Entry {
+        Key key;
+        Value value;
+        size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    struct Location {
+        Segment segment;
+        typename EntryList::iterator entry;
+    };
+
+    // Count-min sketch of 4-bit-ish saturating counters with periodic halving,
+    // so old popularity fades out
+    class FrequencySketch {
+    public:
+        static constexpr size_t WIDTH = 1U << 14;
+        static constexpr uint8_t MAX_COUNT = 15;
+        static constexpr size_t SAMPLE_SIZE = WIDTH * 10;
+
+        void increment(size_t hash) {
+            for (size_t row = 0; row < ROWS; row++) {
+                uint8_t& counter = rows_.at(row).at(index(hash, row));
+                if (counter < MAX_COUNT) {
+                    counter++;
+                }
+            }
+            if (++additions_ >= SAMPLE_SIZE) {
+                age();
+            }
+        }
+
+        uint8_t estimate(size_t hash) const {
+            uint8_t count = MAX_COUNT;
+            for (size_t row = 0; row < ROWS; row++) {
+                count = std::min(count, rows_.at(row).at(index(hash, row)));
+            }
+            return count;
+        }
+
+        void clear() {
+            for (auto& row : rows_) {
+                row.fill(0);
+            }
+            additions_ = 0;
+        }
+
+    private:
+        static constexpr size_t ROWS = 4;
+        static constexpr std::array<uint64_t, ROWS> SEEDS = {
+            0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+            0x27D4EB2F165667C5ULL};
+
+        static size_t index(size_t hash, size_t row) {
+            uint64_t mixed = (static_cast<uint64_t>(hash) + SEEDS.at(row)) * SEEDS.at(row);
+            return static_cast<size_t>(mixed >> 32) & (WIDTH - 1);
+        }
+
+        void age() {
+            for (auto& row : rows_) {
+                for (uint8_t& counter : row) {
+                    counter = static_cast<uint8_t>(counter / 2);
+                }
+            }
+            additions_ /= 2;
+        }
+
+        std::array<std::array<uint8_t, WIDTH>, ROWS> rows_{};
+        size_t additions_ = 0;
+    };
+
+    EntryList& segment_list(Segment segment) {
+        switch (segment) {
+        case Segment::Window:
+            return window_;
+        case Segment::Probation:
+            return probation_;
+        case Segment::Protected:
+            return protected_;
+        }
+        return window_;
+    }
+
+    size_t& segment_bytes(Segment segment) {
+        switch (segment) {
+        case Segment::Window:
+            return window_bytes_;
+        case Segment::Probation:
+            return probation_bytes_;
+        case Segment::Protected:
+            return protected_bytes_;
+        }
+        return window_bytes_;
+    }
+
+    // Moves an entry to the front of `to` (same or different segment)
+    void move_to(Location& location, Segment to) {
+        EntryList& from_list = segment_list(location.segment);
+        EntryList& to_list = segment_list(to);
+        size_t bytes = location.entry->bytes;
+        to_list.splice(to_list.begin(), from_list, location.entry);
+        segment_bytes(location.segment) -= bytes;
+        segment_bytes(to) += bytes;
+        location.segment = to;
+        location.entry = to_list.begin();
+    }
+
+    void touch(Location& location) {
+        if (location.segment == Segment::Probation) {
+            // Second hit: promote, demoting protected entries that no longer fit
+            move_to(location, Segment::Protected);
+            while (protected_bytes_ > protected_budget_ && protected_.size() > 1) {
+                move_to(lookup_.at(protected_.back().key), Segment::Probation);
+            }
+        } else {
+            move_to(location, location.segment);
+        }
+    }
+
+    void evict_entry(Segment segment) {
+        EntryList& list = segment_list(segment);
+        segment_bytes(segment) -= list.back().bytes;
+        lookup_.erase(list.back().key);
+        list.pop_back();
+    }
+
+    size_t main_bytes() const { return probation_bytes_ + protected_bytes_; }
+
+    // Oldest probation entry, or oldest protected entry if probation is empty
+    Segment victim_segment() const {
+        return probation_.empty() ? Segment::Protected : Segment::Probation;
+    }
+
+    void evict_overflow() {
+        while (window_bytes_ > window_budget_ && !window_.empty()) {
+            // The window's oldest entry becomes a candidate for the main region
+            Location& candidate = lookup_.at(window_.back().key);
+            size_t candidate_bytes = candidate.entry->bytes;
+            uint8_t candidate_freq = sketch_.estimate(hash_(candidate.entry->key));
+
+            bool admitted = true;
+            while (main_bytes() + candidate_bytes > main_budget_ && main_bytes() > 0) {
+                Segment victim = victim_segment();
+                const Entry& victim_entry = segment_list(victim).back();
+                if (candidate_freq <= sketch_.estimate(hash_(victim_entry.key))) {
+                    admitted = false;
+                    break;
+                }
+                evict_entry(victim);
+                stats_.evictions++;
+            }
+
+            if (admitted) {
+                move_to(candidate, Segment::Probation);
+            } else {
+                evict_entry(Segment::Window);
+                stats_.rejections++;
+            }
+        }
+        while (main_bytes() > main_budget_ && main_bytes() > 0) {
+            evict_entry(victim_segment());
+            stats_.evictions++;
+        }
+    }
+
+    size_t budget_bytes_ = 0;
+    size_t window_budget_ = 0;
+    size_t main_budget_ = 0;
+    size_t protected_budget_ = 0;
+
+    EntryList window_;
+    EntryList probation_;
+    EntryList protected_;
+    size_t window_bytes_ = 0;
+    size_t probation_bytes_ = 0;
+    size_t protected_bytes_ = 0;
+    std::unordered_map<Key, Location> lookup_;
+
+    std::hash<Key> hash_;
+    FrequencySketch sketch_;
+    CacheStats stats_;
+};
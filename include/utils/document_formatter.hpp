@@ -0,0 +1,92 @@
+#pragma once
+
+#include "utils/byte_budget_cache.hpp"
+#include "utils/document_search.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// A document ready for display: its pretty-printed text plus, when requested,
+// the raw match offsets for a query the search did not record for it
+struct MaterializedDocument {
+    std::shared_ptr<const FormattedJson> formatted;
+    SearchQuery scanned_query; // Query `scanned_offsets` belong to (empty text: none)
+    std::vector<uint64_t> scanned_offsets;
+
+    size_t memory_bytes() const {
+        return formatted->memory_bytes() + scanned_offsets.capacity() * sizeof(uint64_t);
+    }
+};
+
+// Formats documents on the worker pool so the UI thread never does
+// O(document size) work. request() returns the finished document, or starts a
+// High-priority job and returns nullptr; the caller shows a placeholder with
+// progress() and asks again next frame. Documents requested last frame are
+// kept even if the cache declines them; jobs nobody asked for last frame
+// (e.g. the node was collapsed) are cancelled. prefetch() formats ahead of
+// need at Low priority; those jobs live until done or cancel_prefetch().
+// Not thread-safe: owned by the UI thread (jobs only touch their own state).
+class DocumentFormatter {
+public:
+    static constexpr size_t CACHE_BUDGET_BYTES = 256ULL * 1024ULL * 1024ULL; // 256MB
+
+    static DocumentFormatter& instance();
+
+    // Releases documents and jobs not requested since the previous call (once per frame)
+    void begin_frame();
+
+    // Pass a non-empty `scan_query` to also collect its raw match offsets
+    std::shared_ptr<const MaterializedDocument> request(const DatasetSnapshot& snapshot,
+                                                        size_t index,
+                                                        const SearchQuery& scan_query = {});
+    // Fraction of a pending job's document processed so far, in [0, 1]
+    float progress(size_t index) const;
+
+    // Formats a document into the cache in the background, unless it is already there
+    void prefetch(const DatasetSnapshot& snapshot, size_t index);
+    // Cancels prefetch jobs nobody has requested yet (e.g. the scroll direction changed)
+    void cancel_prefetch();
+
+    // Cancels pending jobs and drops cached documents
+    void clear();
+    CacheStats cache_stats() const { return cache_.stats(); }
+
+private:
+    DocumentFormatter() = default;
+
+    // Written by the worker, read by the UI thread once `done` is set
+    struct PendingJob {
+        JobHandle handle;
+        SearchQuery scan_query;
+        size_t total_bytes = 0;
+        std::atomic<size_t> bytes_done{0};
+        std::atomic<bool> done{false};
+        std::shared_ptr<const MaterializedDocument> result;
+        bool requested = true; // UI thread only
+        bool prefetch = false;  // UI thread only
+    };
+
+    struct InUse {
+        std::shared_ptr<const MaterializedDocument> document;
+        bool requested = true;
+    };
+
+    void sync_generation(const DatasetSnapshot& snapshot);
+    void start_job(const DatasetSnapshot& snapshot, size_t index, const SearchQuery& scan_query,
+                   std::shared_ptr<const FormattedJson> formatted, JobPriority priority);
+
+    size_t generation_ = 0;
+    std::unordered_map<size_t, std::shared_ptr<PendingJob>> pending_;
+    std::unordered_map<size_t, InUse> in_use_;
+    ByteBudgetCache<size_t, std::shared_ptr<const MaterializedDocument>> cache_{
+        CACHE_BUDGET_BYTES};
+};
+
+DocumentFormatter& get_document_formatter();
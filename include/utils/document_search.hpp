@@ -0,0 +1,68 @@
+#pragma once
+
+#include "utils/result_set.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Kind of match a search performs against each raw document
+enum class SearchKind : uint8_t {
+    Substring, // Plain byte substring
+};
+
+// A single search request; together with the data generation it identifies a result set
+struct SearchQuery {
+    SearchKind kind = SearchKind::Substring;
+    std::string text;
+
+    bool operator==(const SearchQuery& other) const = default;
+};
+
+// Byte offsets of every match, grouped per matching document (CSR layout). Offsets
+// are 64-bit: a single document (the `huge` dataset shape) can exceed 4GB.
+// Documents must be added in ascending order, as a search scan produces them.
+// Recording stops once MAX_OFFSETS is reached; callers fall back to
+// find_matches() on the single document for anything not recorded.
+class MatchOffsets {
+public:
+    void add_document(uint64_t doc_index, std::span<const uint64_t> offsets);
+    // Appends offsets recorded for documents that all follow this one's
+    void append(const MatchOffsets& later);
+    // Offsets for the document, or an empty span if none were recorded
+    std::span<const uint64_t> find(uint64_t doc_index) const;
+    bool is_recorded(uint64_t doc_index) const;
+    void clear();
+    size_t memory_bytes() const;
+
+private:
+    static constexpr size_t MAX_OFFSETS = 8ULL * 1024ULL * 1024ULL; // 64MB of offsets
+
+    std::vector<uint64_t> documents_;
+    std::vector<size_t> starts_; // Index of each document's first offset in offsets_
+    std::vector<uint64_t> offsets_;
+    bool truncated_ = false;
+};
+
+// Matching documents plus where in each document the matches are
+struct SearchResults {
+    ResultSet matches;
+    MatchOffsets offsets;
+
+    void clear();
+    size_t memory_bytes() const { return matches.memory_bytes() + offsets.memory_bytes(); }
+};
+
+// True if the raw document matches the query
+bool document_matches(const SearchQuery& query, std::string_view document);
+
+// Appends the byte offset of every non-overlapping match to `offsets`; returns the match count
+size_t find_matches(const SearchQuery& query, std::string_view document,
+                    std::pmr::vector<uint64_t>& offsets);
+
+// Length in bytes of each match reported by find_matches()
+size_t match_length(const SearchQuery& query);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Per-frame monotonic allocator for UI scratch data (formatted documents,
+// match lists, ...). Allocation is a pointer bump, deallocation is a no-op and
+// reset() drops everything at once. A frame that outgrows the buffer is served
+// from the heap, and the next reset() grows the buffer to that frame's size,
+// so steady-state frames never touch the heap. After DECAY_FRAMES frames in a
+// row that used at most a quarter of a grown buffer, it shrinks back to twice
+// their peak (not below INITIAL_CAPACITY), so one huge frame is not kept for
+// the rest of the session.
+// Not thread-safe: owned by the UI thread. Nothing allocated from it may
+// outlive the frame.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t INITIAL_CAPACITY = 1024ULL * 1024ULL; // 1MB
+    static constexpr size_t DECAY_FRAMES = 600;                   // About 10 s at 60 Hz
+    static constexpr size_t LOW_WATER_DIVISOR = 4;
+
+    explicit FrameArena(size_t capacity = INITIAL_CAPACITY);
+
+    // Releases this frame's allocations (call once per frame, at NewFrame)
+    void reset();
+
+    size_t bytes_used() const { return offset_ + overflow_bytes_; }
+    size_t capacity() const { return capacity_; }
+    size_t peak_bytes() const { return peak_bytes_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*ptr*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+    std::vector<std::unique_ptr<std::byte[]>> overflow_; // Blocks past the buffer, this frame only
+    size_t overflow_bytes_ = 0;
+    size_t peak_bytes_ = 0;
+    size_t low_frames_ = 0;     // Consecutive frames under the low-water mark
+    size_t low_peak_bytes_ = 0; // Largest of those frames
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Result of one batch of an incremental job
+struct JobStep {
+    size_t units_done = 0; // Documents, lines, ... whatever the job counts
+    bool finished = false;
+};
+
+// Runs incremental UI-thread jobs (search, formatting, prefetch) inside a
+// per-frame time budget measured with a steady clock. Each job reports how
+// many units of work it did; the scheduler tracks the cost per unit and sizes
+// the next batch so the whole frame stays under FRAME_TARGET.
+// Not thread-safe: owned by the UI thread.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using JobId = uint64_t;
+    // Processes at most `max_units` units of work; must not add or cancel jobs
+    using StepFn = std::function<JobStep(size_t max_units)>;
+
+    static constexpr std::chrono::microseconds FRAME_TARGET{16000};
+    static constexpr std::chrono::microseconds RENDER_RESERVE{4000}; // Left for render/present
+    static constexpr std::chrono::microseconds MIN_WORK_BUDGET{1000}; // Always make progress
+
+    static FrameScheduler& instance();
+
+    JobId add(std::string name, StepFn step);
+    void cancel(JobId job_id);
+    bool is_running(JobId job_id) const;
+
+    // Marks the start of a frame (call before polling/drawing)
+    void begin_frame();
+    // Runs pending jobs until the frame's work budget is spent (call after drawing panels)
+    void run_frame();
+
+    Clock::duration last_work_time() const { return last_work_time_; }
+    // True while jobs still have work they could do right now (they made progress last
+    // frame); jobs only waiting on workers rely on the workers waking the UI instead
+    bool wants_next_frame() const { return made_progress_ && !jobs_.empty(); }
+
+private:
+    FrameScheduler() = default;
+
+    static constexpr size_t MAX_BATCH = 1000000;
+    static constexpr double COST_SMOOTHING = 0.3; // Weight of the newest cost sample
+
+    struct Job {
+        JobId id = 0;
+        std::string name;
+        StepFn step;
+        double ns_per_unit = 0.0; // 0 until the first batch has been measured
+        bool finished = false;
+    };
+
+    static size_t batch_for(const Job& job, Clock::duration budget);
+
+    std::vector<Job> jobs_;
+    JobId next_id_ = 1;
+    size_t next_job_ = 0; // Round-robin start, so no job starves another
+    Clock::time_point frame_start_ = Clock::now();
+    Clock::duration last_work_time_{};
+    bool made_progress_ = false;
+};
+
+FrameScheduler& get_frame_scheduler();
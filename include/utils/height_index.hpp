@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Prefix-sum index of list row heights for variable-height virtualization.
+// Every row starts at a default height; rows measured at a different height
+// (expanded documents) are stored as sparse deltas. Rows are grouped into
+// blocks of BLOCK_ROWS, and a Fenwick tree over per-block delta sums gives
+// O(log n) row -> offset and offset -> row, so memory is O(n / BLOCK_ROWS +
+// measured rows) even for billions of rows.
+// Offsets are doubles: exact for integral pixel heights far past 2^31 rows.
+class HeightIndex {
+public:
+    static constexpr uint64_t BLOCK_ROWS = 4096;
+
+    // Drops all measured heights
+    void reset(uint64_t row_count, double default_height);
+    // Grows or shrinks the row count, keeping heights of surviving rows
+    void resize(uint64_t row_count);
+
+    void set_height(uint64_t row, double height);
+    double height(uint64_t row) const;
+
+    // Top of `row` (row_count() gives the total height)
+    double offset_of(uint64_t row) const;
+    // Row containing `offset`, clamped to the last row (0 when empty)
+    uint64_t row_at(double offset) const;
+    double total_height() const { return offset_of(row_count_); }
+
+    uint64_t row_count() const { return row_count_; }
+    double default_height() const { return default_height_; }
+    size_t measured_rows() const { return deltas_.size(); }
+    // Approximate heap bytes: one map node per measured row plus the tree
+    size_t memory_bytes() const {
+        return deltas_.size() * MAP_NODE_BYTES + tree_.capacity() * sizeof(double);
+    }
+
+private:
+    static constexpr size_t MAP_NODE_BYTES = 48; // Red-black node links plus the entry
+
+    void add_block_delta(uint64_t block, double delta);
+    double block_delta_prefix(uint64_t blocks) const; // Sum of deltas in blocks [0, blocks)
+    void rebuild_tree();
+
+    uint64_t row_count_ = 0;
+    double default_height_ = 0.0;
+    std::map<uint64_t, double> deltas_; // Row -> height - default_height_
+    std::vector<double> tree_;          // 1-based Fenwick tree over block delta sums
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "utils/json_data_store.hpp"
+
+#include <string>
+#include <vector>
+
+// Sidecar document index ("<file>.jvidx") written by `--headless index`.
+// Loading an NDJSON file with a matching sidecar skips the indexing pass.
+// The sidecar records the source file's size and modification time plus the
+// decompressed size, and is ignored as soon as any of them differ.
+std::string index_file_path(const std::string& file_path);
+
+// Writes the snapshot's document index next to `file_path`; false on I/O error
+bool save_index_file(const std::string& file_path, const DatasetSnapshot& snapshot);
+
+// Fills `index` from a valid sidecar for `file_path` whose raw data is
+// `raw_size` bytes; false (and `index` untouched) if missing or stale
+bool load_index_file(const std::string& file_path, size_t raw_size,
+                     std::vector<DocumentIndex>& index);
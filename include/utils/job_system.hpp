@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Queue order for worker jobs: visible-row work runs ahead of background scans
+enum class JobPriority : uint8_t {
+    High,   // Work the user is waiting on (visible rows, formatting)
+    Normal, // Loading
+    Low,    // Background scans and prefetch
+};
+
+// Shared cancellation flag, checked cooperatively by long-running jobs.
+// Copies share the same flag.
+class CancellationToken {
+public:
+    CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { flag_->store(true, std::memory_order_relaxed); }
+    bool is_cancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+// Joinable handle to a submitted job. Default-constructed handles are "done".
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    bool valid() const { return state_ != nullptr; }
+    bool is_done() const;
+    void wait() const;
+    void cancel() const;
+    CancellationToken token() const;
+
+private:
+    friend class JobSystem;
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable done_cv;
+        bool done = false;
+        CancellationToken token;
+    };
+
+    explicit JobHandle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+// Process-wide worker pool. Sized once from the CPUs this process may
+// actually use (affinity mask and cgroup CPU quota), replacing ad-hoc
+// detached threads for loading, search, formatting and prefetch.
+class JobSystem {
+public:
+    using JobFn = std::function<void(const CancellationToken&)>;
+
+    static JobSystem& instance();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem();
+
+    // Queues a job; jobs already cancelled when dequeued are skipped
+    JobHandle submit(JobPriority priority, JobFn job, CancellationToken token = {});
+    size_t worker_count() const { return workers_.size(); }
+
+    // Cancels queued and running jobs and joins the workers (call before exit)
+    void shutdown();
+
+private:
+    JobSystem();
+
+    static constexpr size_t MIN_WORKERS = 2; // A long load must not starve interactive jobs
+
+    struct Task {
+        JobFn job;
+        std::shared_ptr<JobHandle::State> state;
+    };
+
+    void worker_loop(size_t worker_index);
+    static void finish(JobHandle::State& state);
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::array<std::deque<Task>, 3> queues_; // One per JobPriority
+    std::vector<std::shared_ptr<JobHandle::State>> running_; // Per worker, for shutdown
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+JobSystem& get_job_system();
+
+// Number of CPUs available to this process (affinity mask and cgroup quota aware)
+size_t available_cpu_count();
@@ -1,13 +1,15 @@
 #pragma once
 
+#include "utils/byte_budget_cache.hpp"
+
 #include <atomic>
 #include <cstddef>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <simdjson.h>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -16,38 +18,84 @@ struct DocumentIndex {
     size_t byte_length_; // Length of this document
 };
 
+// One loaded file: raw bytes plus the per-document index.
+// Built privately by the loader, then published whole and never modified.
+struct Dataset {
+    simdjson::padded_string raw_data;
+    std::vector<DocumentIndex> index;
+};
+
+// Read-only, reference-counted view of one published dataset.
+// Holding a snapshot keeps its raw buffer alive, so the string_views it hands
+// out stay valid across reset() or a newly published file. Cheap to copy;
+// reads take no lock and copy nothing.
+class DatasetSnapshot {
+public:
+    DatasetSnapshot() = default;
+    DatasetSnapshot(std::shared_ptr<const Dataset> dataset, size_t generation)
+        : dataset_(std::move(dataset)), generation_(generation) {}
+
+    bool valid() const { return dataset_ != nullptr; }
+    size_t generation() const { return generation_; }
+    size_t document_count() const { return dataset_ ? dataset_->index.size() : 0; }
+    size_t raw_size() const { return dataset_ ? dataset_->raw_data.size() : 0; }
+    // The whole raw buffer (padded like document())
+    std::string_view raw_data() const {
+        return dataset_ ? std::string_view(dataset_->raw_data) : std::string_view();
+    }
+    std::span<const DocumentIndex> index() const {
+        return dataset_ ? std::span<const DocumentIndex>(dataset_->index)
+                        : std::span<const DocumentIndex>();
+    }
+
+    // View into the raw buffer (empty if out of range). At least
+    // SIMDJSON_PADDING readable bytes follow every view, so simdjson can
+    // parse it in place.
+    std::string_view document(size_t index) const {
+        if (!dataset_ || index >= dataset_->index.size()) {
+            return {};
+        }
+        const DocumentIndex& doc_idx = dataset_->index[index];
+        return {dataset_->raw_data.data() + doc_idx.byte_offset_, doc_idx.byte_length_};
+    }
+
+private:
+    std::shared_ptr<const Dataset> dataset_;
+    size_t generation_ = 0;
+};
+
 class JsonDataStore {
 public:
     static JsonDataStore& instance();
 
     // Called by parser
     void reset();
-    void set_raw_data(simdjson::padded_string&& data);
-    void add_document_index(size_t offset, size_t length);
-    void set_complete();
+    // Swaps in a fully built dataset; the previous one stays browsable until then
+    void publish(std::shared_ptr<const Dataset> dataset);
 
     // Called by viewer panel
     size_t document_count() const;
-    std::string get_document(size_t index); // On-demand parsing
+    // Copying access through the document cache; scans should pass CacheHint::Scan
+    std::string get_document(size_t index, CacheHint hint = CacheHint::Normal);
+    DatasetSnapshot snapshot() const; // Zero-copy access for hot paths
+    CacheStats document_cache_stats() const;
+    // Bytes held by the published dataset (memory accounting)
+    size_t raw_data_bytes() const;
+    size_t index_bytes() const;
     bool is_ready() const;
     size_t generation() const; // Increments on each reset
 
 private:
     JsonDataStore() = default;
 
-    std::unique_ptr<simdjson::padded_string> raw_data_;
-    std::vector<DocumentIndex> index_;
+    std::shared_ptr<const Dataset> dataset_;
     std::atomic<bool> is_ready_{false};
     std::atomic<size_t> generation_{0};
     mutable std::mutex mutex_;
 
-    // LRU cache for recently accessed documents
-    static constexpr size_t CACHE_SIZE = 100;
-    mutable std::list<std::pair<size_t, std::string>> cache_list_;
-    mutable std::unordered_map<size_t, decltype(cache_list_)::iterator> cache_map_;
-
-    std::string get_cached_or_parse(size_t index) const;
-    void add_to_cache(size_t index, const std::string& doc) const;
+    // Byte-bounded, scan-resistant cache for recently accessed documents
+    static constexpr size_t CACHE_BUDGET_BYTES = 64ULL * 1024ULL * 1024ULL; // 64MB
+    ByteBudgetCache<size_t, std::string> cache_{CACHE_BUDGET_BYTES};
 };
 
 JsonDataStore& get_json_data();
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Maps byte offsets in a raw document to offsets in its pretty-printed text.
+// Stores a checkpoint wherever the raw-to-pretty delta changes (i.e. around
+// every skipped or inserted whitespace run), so lookups are a binary search.
+class PositionMap {
+public:
+    explicit PositionMap(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : checkpoints_(memory) {}
+
+    void add(size_t raw_offset, size_t pretty_offset);
+    size_t to_pretty(size_t raw_offset) const;
+    size_t memory_bytes() const { return checkpoints_.capacity() * sizeof(checkpoints_[0]); }
+
+private:
+    std::pmr::vector<std::pair<size_t, size_t>> checkpoints_; // (raw, pretty), ascending
+};
+
+// Allocates from the given resource, e.g. the frame arena for per-frame scratch copies
+struct FormattedJson {
+    explicit FormattedJson(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : text(memory), positions(memory), line_starts(memory) {}
+
+    std::pmr::string text;
+    PositionMap positions;
+    std::pmr::vector<size_t> line_starts; // Offset of the first byte of each line in `text`
+
+    size_t line_count() const { return line_starts.size(); }
+    // Line containing the given offset in `text`
+    size_t line_of(size_t pretty_offset) const;
+    // Approximate heap footprint, for cache budgeting
+    size_t memory_bytes() const {
+        return text.capacity() + positions.memory_bytes() +
+               line_starts.capacity() * sizeof(line_starts[0]);
+    }
+};
+
+// Reports raw bytes processed so far; returning false aborts formatting
+using FormatProgressFn = std::function<bool(size_t raw_bytes_done)>;
+constexpr size_t FORMAT_PROGRESS_INTERVAL = 1024ULL * 1024ULL; // 1MB
+
+// Pretty-print JSON with indentation.
+// Tokens are copied verbatim from the raw bytes (only whitespace changes), so
+// raw offsets such as search matches can be mapped into the output.
+// Invalid JSON is returned as-is with an identity position map.
+// Pass input_is_padded when SIMDJSON_PADDING readable bytes follow the view
+// (e.g. DatasetSnapshot::document()), so it is parsed without a copy.
+// `progress` is called every FORMAT_PROGRESS_INTERVAL bytes; an aborted call
+// returns an empty result.
+FormattedJson format_json(std::string_view raw_json, bool input_is_padded = false,
+                          std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                          const FormatProgressFn& progress = {});
+
+// Appends `text` as a quoted JSON string literal: quotes and backslashes are
+// escaped, control characters written as \u00XX. Bytes >= 0x80 pass through.
+void append_json_string(std::string& out, std::string_view text);
+std::string json_string(std::string_view text);
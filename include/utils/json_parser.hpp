@@ -1,5 +1,24 @@
 #pragma once
 
+#include "utils/job_system.hpp"
+
 #include <string>
 
-void json_parser(const std::string& file_path);
+// Loads a file into a new dataset and publishes it to the data store on success.
+// Cancelling the token stops reading, inflating and indexing and keeps the current dataset.
+void json_parser(const std::string& file_path, const CancellationToken& token = {});
+
+// When enabled (headless and benchmark runs), each load ends by writing
+// LoadingState::summary_json() as one line on stderr. Off by default.
+void set_load_summary_output(bool enabled);
+
+// Loads the file on the shared worker pool. A load already in flight is
+// cancelled and this one starts once it has finished, so loads never overlap;
+// of several requests made meanwhile only the latest is loaded.
+void start_json_load(const std::string& file_path);
+
+// Cancels the load in flight and drops a requested one, if any
+void cancel_json_load();
+
+// True from start_json_load() until that load (and any requested after it) has finished
+bool json_load_in_progress();
@@ -1,8 +1,41 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+
+// Stages of a load. Gzip input is read and inflated in one pass, timed as Decompress.
+enum class LoadPhase : uint8_t {
+    Read,         // Plain file from disk
+    Decompress,   // Gzip file from disk, inflated
+    Index,        // NDJSON document boundaries
+    Validate,     // Structural parse of a single JSON document
+    IndexPersist, // Saved index sidecar
+    Count,
+};
+
+constexpr size_t LOAD_PHASE_COUNT = static_cast<size_t>(LoadPhase::Count);
+
+// Lower-case name used in the load summary ("read", "index_persist", ...)
+const char* load_phase_name(LoadPhase phase);
+
+// Time spent in one phase and the input bytes it consumed
+struct LoadPhaseStats {
+    std::atomic<double> seconds{0.0};
+    std::atomic<size_t> bytes{0};
+};
+
+// Running phase as seen by the UI
+struct LoadProgress {
+    LoadPhase phase = LoadPhase::Count; // Count: no phase running
+    size_t bytes_done = 0;
+    size_t bytes_total = 0; // 0: unknown
+    double bytes_per_second = 0.0;
+    double eta_seconds = -1.0; // Negative: unknown
+};
 
 // Shared state for loading progress (thread-safe)
 struct LoadingState {
@@ -13,6 +46,9 @@ struct LoadingState {
     std::string status_message;
     std::string error_message;
 
+    // Per-phase totals of the current (or last) load; written by the loader only
+    std::array<LoadPhaseStats, LOAD_PHASE_COUNT> phases;
+
     void reset() {
         is_loading = false;
         is_complete = false;
@@ -20,7 +56,36 @@ struct LoadingState {
         file_size_bytes = 0;
         status_message.clear();
         error_message.clear();
+        for (LoadPhaseStats& stats : phases) {
+            stats.seconds = 0.0;
+            stats.bytes = 0;
+        }
+        current_phase = LoadPhase::Count;
+        phase_bytes_done = 0;
+        phase_bytes_total = 0;
+    }
+
+    // Ends the running phase (if any) and starts `phase` over `total_bytes` of input
+    void begin_phase(LoadPhase phase, size_t total_bytes);
+    // Input bytes the running phase has consumed so far
+    void advance_phase(size_t bytes_done) {
+        phase_bytes_done.store(bytes_done, std::memory_order_relaxed);
     }
+    // Adds the running phase's time and bytes to `phases`
+    void end_phase();
+
+    // Throughput and ETA of the running phase, from the bytes consumed so far
+    LoadProgress progress() const;
+
+    // One-line JSON record of the finished load: outcome, sizes and per-phase stats
+    std::string summary_json(std::string_view file_path, std::string_view outcome,
+                             double total_seconds) const;
+
+private:
+    std::atomic<LoadPhase> current_phase{LoadPhase::Count};
+    std::atomic<size_t> phase_bytes_done{0};
+    std::atomic<size_t> phase_bytes_total{0};
+    std::atomic<int64_t> phase_start_ns{0}; // steady_clock
 };
 
 // Global loading state (accessible from UI and parser)
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Memory accounting: every large structure registers a reporter returning the
+// bytes it currently holds, and memory_report() collects them next to the
+// process RSS. Reporters run on the calling thread, so structures owned by the
+// UI thread must be reported from it (or where no UI runs, as in headless mode).
+// Items are allocated bytes: pages never touched (parser buffers are sized for
+// the worst case) do not show up in RSS.
+
+struct MemoryUsage {
+    const char* name;
+    size_t bytes;
+};
+
+struct MemoryReport {
+    std::vector<MemoryUsage> items; // Registration order
+    size_t accounted_bytes = 0;     // Sum of items
+    size_t rss_bytes = 0;           // 0 if unknown on this platform
+    size_t peak_rss_bytes = 0;      // 0 if unknown on this platform
+};
+
+// `name` must be an identifier-like string literal (it is written to JSON
+// unescaped); reporters must stay callable until exit
+void register_memory_reporter(const char* name, std::function<size_t()> reporter);
+
+MemoryReport memory_report();
+
+// One-line JSON: {"rss_bytes":..,"peak_rss_bytes":..,"accounted_bytes":..,"items":{name:bytes}}
+std::string memory_report_json(const MemoryReport& report);
+
+// Helper struct for static registration, like PanelRegistrar
+struct MemoryReporterRegistrar {
+    MemoryReporterRegistrar(const char* name, std::function<size_t()> reporter) {
+        register_memory_reporter(name, std::move(reporter));
+    }
+};
+
+// Usage at namespace scope: REGISTER_MEMORY_REPORTER(document_cache, [] { return ...; });
+#define REGISTER_MEMORY_REPORTER(name, reporter)                                                   \
+    static MemoryReporterRegistrar _memory_reporter_##name(#name, reporter)
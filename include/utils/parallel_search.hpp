@@ -0,0 +1,47 @@
+#pragma once
+
+#include "utils/document_search.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Scans every document on the shared worker pool in fixed-size chunks.
+// collect() moves finished chunks into the caller's results in document
+// order, so the match set grows front-to-back just like a sequential scan
+// and can be merged a little at a time from the UI thread. Workers read the
+// snapshot's raw buffer directly, without locking or copying documents.
+class ParallelSearch {
+public:
+    static constexpr size_t CHUNK_DOCUMENTS = 16384;
+
+    ParallelSearch(SearchQuery query, const DatasetSnapshot& snapshot,
+                   JobPriority priority = JobPriority::Low);
+    ~ParallelSearch();
+
+    ParallelSearch(const ParallelSearch&) = delete;
+    ParallelSearch& operator=(const ParallelSearch&) = delete;
+
+    // Appends up to `max_chunks` completed chunks to `results`; returns chunks merged
+    size_t collect(SearchResults& results, size_t max_chunks);
+    bool is_complete() const { return next_chunk_ == chunks_.size(); }
+    // Blocks until every chunk has been scanned (headless callers)
+    void wait() const;
+    // Documents covered by the chunks collected so far
+    size_t documents_scanned() const;
+    void cancel();
+
+private:
+    struct Chunk {
+        size_t begin = 0;
+        size_t end = 0;
+        SearchResults results;
+        JobHandle handle;
+    };
+
+    CancellationToken token_;
+    std::vector<std::shared_ptr<Chunk>> chunks_;
+    size_t next_chunk_ = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <simdjson.h>
+
+// Thread-local simdjson parsers that keep their buffers between calls, so
+// steady-state parsing allocates nothing. Each thread owns one dom and one
+// ondemand parser; the returned reference must not leave the calling thread.
+// Capacity grows with the largest document. It shrinks back when a later
+// request needs less than half of it and the capacity has gone unused for
+// SHRINK_DELAY, or when release_local_parsers() runs.
+simdjson::dom::parser& local_dom_parser(size_t document_size);
+simdjson::ondemand::parser& local_ondemand_parser(size_t document_size);
+
+// Call once the calling thread's parse results are no longer used (the job
+// system does after every job). Shrinks this thread's parsers to the last
+// document's size, and to at most MAX_RETAINED_CAPACITY, once they hold more
+// than that and have not been needed for SHRINK_DELAY. A thread alternating
+// large and small documents keeps its buffers.
+void trim_local_parsers();
+
+// Like trim_local_parsers() but without the delay, for one-off parses (a
+// whole-file document at load) whose buffers would otherwise stay pinned.
+void release_local_parsers();
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+#include "utils/result_set.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Warms the rows the list is about to show. Fed the visible rank range every
+// frame, it tracks scroll velocity and, while the list is moving, looks
+// SCREENS_AHEAD screens (plus LOOKAHEAD_FRAMES of travel at the current speed)
+// ahead in the scroll direction:
+//  - expanded rows are formatted into the DocumentFormatter cache, and
+//  - the raw bytes of those rows are madvise(MADV_WILLNEED)'d, so pages that
+//    were swapped out are read back before they are drawn.
+// The lookahead is capped at MAX_PREFETCH_ROWS, and a jump of more than
+// REPOSITION_SCREENS screens in one frame (scrollbar drag, jump to a match)
+// counts as a reposition, not as speed.
+// Turning around cancels everything still queued for the old direction.
+// Not thread-safe: owned by the UI thread.
+class Prefetcher {
+public:
+    // Whether a row's tree node is open (only open rows are formatted ahead)
+    using IsExpandedFn = bool (*)(size_t document_index);
+
+    static constexpr size_t SCREENS_AHEAD = 2;
+    static constexpr double LOOKAHEAD_FRAMES = 30.0;
+    static constexpr double MIN_VELOCITY = 0.5;        // Rows/frame; slower counts as idle
+    static constexpr double VELOCITY_SMOOTHING = 0.3;  // Weight of the newest sample
+    static constexpr size_t ADVISE_GAP = 4096;         // Bytes of gap still merged into one run
+    static constexpr size_t MAX_PREFETCH_ROWS = 512;   // Rows issued ahead at most
+    static constexpr size_t REPOSITION_SCREENS = 4;
+
+    static Prefetcher& instance();
+
+    // `rows` is the displayed set; [first_visible, last_visible) are ranks within it.
+    // `rows_version` must change whenever the contents of `rows` do.
+    void update(const DatasetSnapshot& snapshot, const ResultSet& rows, uint64_t rows_version,
+                size_t first_visible, size_t last_visible, IsExpandedFn is_expanded);
+    void cancel();
+
+    double velocity() const { return velocity_; }
+
+private:
+    Prefetcher() = default;
+
+    void prefetch_range(const DatasetSnapshot& snapshot, const ResultSet& rows, size_t begin,
+                        size_t end, IsExpandedFn is_expanded);
+
+    size_t generation_ = 0;
+    const ResultSet* rows_ = nullptr;
+    uint64_t rows_version_ = 0;
+    uint64_t row_count_ = 0;
+    size_t last_first_visible_ = 0;
+    double velocity_ = 0.0;
+    int direction_ = 0;
+    size_t prefetched_begin_ = 0; // Rank range already issued for the current direction
+    size_t prefetched_end_ = 0;
+    CancellationToken token_;
+};
+
+Prefetcher& get_prefetcher();
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "utils/document_search.hpp"
+
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Recently computed search results, so re-running a recent query is instant.
+// Entries are keyed by query and JsonDataStore::generation(); a new generation
+// drops every entry. Bounded by the size of the stored result sets and offsets.
+// Not thread-safe: owned by the UI thread.
+class QueryCache {
+public:
+    static QueryCache& instance();
+
+    std::optional<SearchResults> find(const SearchQuery& query, size_t generation);
+    void insert(const SearchQuery& query, size_t generation, const SearchResults& results);
+    void clear();
+
+    size_t memory_bytes() const { return bytes_used_; }
+    size_t entry_count() const { return entries_.size(); }
+
+private:
+    QueryCache() = default;
+
+    static constexpr size_t MEMORY_BUDGET = 64ULL * 1024ULL * 1024ULL; // 64MB
+
+    struct Entry {
+        std::string key;
+        SearchResults results;
+        size_t bytes;
+    };
+
+    static std::string make_key(const SearchQuery& query);
+    void drop_stale(size_t generation);
+
+    size_t generation_ = 0;
+    size_t bytes_used_ = 0;
+    std::list<Entry> entries_; // Front is most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup_;
+};
+
+QueryCache& get_query_cache();
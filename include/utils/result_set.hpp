@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed set of document indices (roaring-style).
+// Indices are split into 2^16-wide chunks keyed by their high bits. Each chunk
+// stores its members as a contiguous range, a sorted array (sparse) or a
+// 65536-bit bitmap (dense), whichever is smallest. "All documents" is a handful
+// of range chunks, so clearing a filter is O(n / 65536) instead of O(n).
+class ResultSet {
+public:
+    class Iterator;
+
+    ResultSet() = default;
+
+    // Every index in [0, count)
+    static ResultSet all(uint64_t count);
+    // Every index in [begin, end)
+    static ResultSet range(uint64_t begin, uint64_t end);
+
+    // Appending in ascending order is the fast path (search results arrive that way)
+    void add(uint64_t index);
+    // Appends a set whose members all follow this set's members (chunked scans)
+    void append(const ResultSet& later);
+    bool contains(uint64_t index) const;
+    void clear();
+
+    uint64_t size() const;
+    bool empty() const { return chunks_.empty(); }
+
+    // Returns the rank-th smallest member (rank < size())
+    uint64_t select(uint64_t rank) const;
+
+    // Approximate heap footprint, for cache budgeting
+    size_t memory_bytes() const;
+
+    // Boolean set algebra
+    ResultSet operator&(const ResultSet& other) const; // AND
+    ResultSet operator|(const ResultSet& other) const; // OR
+    ResultSet operator-(const ResultSet& other) const; // AND NOT
+    ResultSet complement(uint64_t universe) const;     // NOT, within [0, universe)
+
+    bool operator==(const ResultSet& other) const;
+
+    Iterator begin() const;
+    Iterator end() const;
+    // Iterator positioned at the rank-th member (used by the list clipper)
+    Iterator iterator_at(uint64_t rank) const;
+
+private:
+    static constexpr uint32_t CHUNK_BITS = 16;
+    static constexpr uint32_t CHUNK_SIZE = 1U << CHUNK_BITS;
+    static constexpr uint32_t BITMAP_WORDS = CHUNK_SIZE / 64;
+    static constexpr uint32_t ARRAY_MAX = 4096; // Above this a bitmap is smaller
+
+    enum class Kind : uint8_t { Range, Array, Bitmap };
+
+    struct Chunk {
+        uint64_t key = 0;       // index >> CHUNK_BITS
+        uint64_t rank_base = 0; // Number of members in all preceding chunks
+        uint32_t cardinality = 0;
+        Kind kind = Kind::Range;
+        uint16_t range_start = 0;       // Kind::Range: [range_start, range_start + cardinality)
+        std::vector<uint16_t> array;    // Kind::Array: sorted members
+        std::vector<uint64_t> bitmap;   // Kind::Bitmap: BITMAP_WORDS words
+
+        bool contains(uint16_t low) const;
+        uint16_t select(uint32_t rank) const;
+        void insert(uint16_t low);
+        void to_bitmap(std::vector<uint64_t>& words) const;
+    };
+
+    enum class Op : uint8_t { And, Or, AndNot };
+
+    static Chunk make_range_chunk(uint64_t key, uint32_t start, uint32_t count);
+    static bool combine_chunks(const Chunk& lhs, const Chunk& rhs, Op op, Chunk& out);
+    static void normalize_from_bitmap(std::vector<uint64_t>& words, Chunk& out);
+    static ResultSet combine(const ResultSet& lhs, const ResultSet& rhs, Op op);
+
+    void push_chunk(Chunk&& chunk);
+
+    std::vector<Chunk> chunks_;
+};
+
+// Forward iterator over the members of a ResultSet in ascending order
+class ResultSet::Iterator {
+public:
+    uint64_t operator*() const { return value_; }
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const {
+        return chunk_ == other.chunk_ && pos_ == other.pos_ && bits_ == other.bits_;
+    }
+
+private:
+    friend class ResultSet;
+
+    Iterator(const ResultSet* set, size_t chunk, uint32_t pos);
+    void load();
+
+    const ResultSet* set_ = nullptr;
+    size_t chunk_ = 0;
+    uint32_t pos_ = 0;  // Range/array: position in chunk; bitmap: word index
+    uint64_t bits_ = 0; // Bitmap: remaining bits of the current word
+    uint64_t value_ = 0;
+};
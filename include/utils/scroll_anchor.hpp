@@ -0,0 +1,33 @@
+#pragma once
+
+#include "utils/height_index.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Scroll position of a virtual list, kept as a 64-bit anchor row plus the
+// pixels scrolled into that row. The list is laid out relative to the anchor,
+// so wheel scrolling stays exact at any depth; only scrollbar
+// drags go through an absolute (double) position. Unlike an absolute offset,
+// the anchor also stays put when rows above it change height.
+class ScrollAnchor {
+public:
+    static constexpr size_t MAX_WALK_ROWS = 64; // Longer moves resolve via the height index
+
+    uint64_t row() const { return row_; }
+    double offset() const { return offset_; }
+
+    // Absolute position in pixels from the top of the list
+    double position(const HeightIndex& heights) const {
+        return heights.offset_of(row_) + offset_;
+    }
+
+    void scroll_to(const HeightIndex& heights, double position);
+    void scroll_by(const HeightIndex& heights, double delta);
+    // Keeps the anchor on a row and the view from running past the end of the list
+    void clamp(const HeightIndex& heights, double view_height);
+
+private:
+    uint64_t row_ = 0;
+    double offset_ = 0.0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+// Timeline recording for chrome://tracing and Perfetto.
+// Each thread appends to its own buffer without locks (a mutex is taken once,
+// the first time a thread records); write_trace() may run at any time and sees
+// every event published so far. Recording is off by default and then costs one
+// relaxed load per call. A thread stops recording after MAX_EVENTS_PER_THREAD.
+// Event names must outlive the trace (string literals).
+
+namespace trace_detail {
+inline std::atomic<bool> enabled{false};
+} // namespace trace_detail
+
+inline bool trace_enabled() {
+    return trace_detail::enabled.load(std::memory_order_relaxed);
+}
+void set_trace_enabled(bool enabled);
+
+// Names the calling thread in the trace ("ui", "worker 2", ...); recorded even while disabled
+void trace_thread_name(const std::string& name);
+
+void trace_begin(const char* name);
+void trace_end(const char* name);
+void trace_counter(const char* name, double value);
+
+// Writes all recorded events as Chrome trace-event JSON; false on I/O error
+bool write_trace(const std::string& path);
+
+// $JSON_VIEWER_TRACE, or "json_viewer_trace.json" when unset
+std::string trace_output_path();
+// Starts recording when JSON_VIEWER_TRACE is set; true if it did (the trace
+// is then written to trace_output_path() on exit)
+bool start_trace_from_environment();
+
+// Begin/end pair around the enclosing scope
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name_(trace_enabled() ? name : nullptr) {
+        if (name_ != nullptr) {
+            trace_begin(name_);
+        }
+    }
+    ~TraceScope() {
+        if (name_ != nullptr) {
+            trace_end(name_);
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Usage: TRACE_SCOPE("search_chunk");
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
@@ -0,0 +1,15 @@
+#pragma once
+
+// Wakes the UI loop while it is blocked waiting for input.
+// main() installs a callback that posts an event to the window system's
+// queue; background work calls request_ui_wake() whenever something the UI
+// shows has changed (a job finished, a progress counter advanced).
+// Requests coalesce until the loop acknowledges them, so at most one wake-up
+// is ever queued.
+using UiWakeFn = void (*)();
+
+void set_ui_wake_callback(UiWakeFn callback);
+// Thread-safe; cheap when a wake-up is already pending
+void request_ui_wake();
+// Called by the UI loop once it is awake, re-arming request_ui_wake()
+void acknowledge_ui_wake();
@@ -0,0 +1,351 @@
+#include "frame_bench.hpp"
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_impl_sdl3.h"
+#include "imgui/imgui_impl_sdlrenderer3.h"
+#include "panel_manager.hpp"
+#include "panels/json_viewer_panel.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
+#include "utils/json_parser.hpp"
+#include "utils/loading_state.hpp"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int WINDOW_WIDTH = 1280;
+constexpr int WINDOW_HEIGHT = 800;
+constexpr size_t MAX_WAIT_FRAMES = 1000000; // Gives up on a load/search that never finishes
+constexpr double MS_PER_SECOND = 1000.0;
+
+// Covers the interactions that regress most easily
+constexpr const char* DEFAULT_TRACE = "frames 60\n"
+                                      "scroll 3 240\n"
+                                      "scroll -3 120\n"
+                                      "jump 0.5\n"
+                                      "frames 30\n"
+                                      "expand 3\n"
+                                      "frames 120\n"
+                                      "scroll 1 120\n"
+                                      "collapse 3\n"
+                                      "search error\n"
+                                      "wait_search\n"
+                                      "scroll 3 120\n"
+                                      "frames 60\n";
+
+using Clock = std::chrono::steady_clock;
+
+struct Command {
+    std::string name;
+    std::string text; // search
+    double value = 0.0;
+    size_t frames = 0;
+};
+
+// Per-phase samples, one per recorded frame, in milliseconds
+struct FrameSamples {
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> samples;
+
+    void add(size_t phase, const char* name, double seconds) {
+        if (phase == names.size()) {
+            names.emplace_back(name);
+            samples.emplace_back();
+        }
+        samples[phase].push_back(seconds * MS_PER_SECOND);
+    }
+};
+
+struct Window {
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+};
+
+std::optional<std::vector<Command>> parse_trace(std::istream& input) {
+    std::vector<Command> commands;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        Command command;
+        if (!(words >> command.name)) {
+            continue;
+        }
+
+        bool ok = true;
+        if (command.name == "frames" || command.name == "expand" || command.name == "collapse") {
+            ok = static_cast<bool>(words >> command.frames);
+        } else if (command.name == "scroll") {
+            ok = static_cast<bool>(words >> command.value >> command.frames);
+        } else if (command.name == "jump") {
+            ok = static_cast<bool>(words >> command.value);
+        } else if (command.name == "search") {
+            std::getline(words >> std::ws, command.text);
+            ok = !command.text.empty();
+        } else if (command.name != "wait_search") {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "error: trace line %zu: %s\n", line_number, line.c_str());
+            return std::nullopt;
+        }
+        commands.push_back(command);
+    }
+    return commands;
+}
+
+bool create_window(Window& out) {
+    // No display needed: render into an offscreen surface (or nowhere)
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        std::fprintf(stderr, "error: SDL_Init(): %s\n", SDL_GetError());
+        return false;
+    }
+    out.window = SDL_CreateWindow("JSON Viewer benchmark", WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    if (out.window == nullptr) {
+        std::fprintf(stderr, "error: SDL_CreateWindow(): %s\n", SDL_GetError());
+        return false;
+    }
+    out.renderer = SDL_CreateRenderer(out.window, nullptr);
+    if (out.renderer == nullptr) {
+        std::fprintf(stderr, "error: SDL_CreateRenderer(): %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_SetRenderVSync(out.renderer, 0);
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = nullptr; // Identical starting layout for every run
+    ImGui::StyleColorsDark();
+    ImGui_ImplSDL3_InitForSDLRenderer(out.window, out.renderer);
+    ImGui_ImplSDLRenderer3_Init(out.renderer);
+    return true;
+}
+
+void destroy_window(Window& window) {
+    if (ImGui::GetCurrentContext() != nullptr) {
+        ImGui_ImplSDLRenderer3_Shutdown();
+        ImGui_ImplSDL3_Shutdown();
+        ImGui::DestroyContext();
+    }
+    if (window.renderer != nullptr) {
+        SDL_DestroyRenderer(window.renderer);
+    }
+    if (window.window != nullptr) {
+        SDL_DestroyWindow(window.window);
+    }
+    SDL_Quit();
+}
+
+// Draws one frame exactly like the interactive loop, with the mouse over the
+// list and `wheel` notches of scrolling; records its phases when `samples` is set
+void draw_frame(const Window& window, float wheel, FrameSamples* samples) {
+    Clock::time_point frame_start = Clock::now();
+    size_t phase = 0;
+    Clock::time_point phase_start = frame_start;
+    auto end_phase = [&](const char* name) {
+        Clock::time_point now = Clock::now();
+        if (samples != nullptr) {
+            samples->add(phase++, name, std::chrono::duration<double>(now - phase_start).count());
+        }
+        phase_start = now;
+    };
+
+    get_frame_scheduler().begin_frame();
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        ImGui_ImplSDL3_ProcessEvent(&event);
+    }
+    ImGui_ImplSDLRenderer3_NewFrame();
+    ImGui_ImplSDL3_NewFrame();
+    ImGuiIO& imgui_io = ImGui::GetIO();
+    imgui_io.AddMousePosEvent(imgui_io.DisplaySize.x * 0.5F, imgui_io.DisplaySize.y * 0.5F);
+    if (wheel != 0.0F) {
+        imgui_io.AddMouseWheelEvent(0.0F, wheel);
+    }
+    ImGui::NewFrame();
+    PanelManager::instance().begin_frame();
+    end_phase("new_frame");
+
+    PanelManager::instance().draw_all();
+    Clock::time_point panels_end = Clock::now();
+    if (samples != nullptr) {
+        for (const PanelManager::PanelTiming& timing :
+             PanelManager::instance().last_frame_timings()) {
+            samples->add(phase++, timing.name, timing.seconds);
+        }
+    }
+    phase_start = panels_end;
+
+    get_frame_scheduler().run_frame();
+    end_phase("scheduler");
+
+    ImGui::Render();
+    end_phase("imgui_render");
+
+    SDL_SetRenderDrawColorFloat(window.renderer, 0.0F, 0.0F, 0.0F, 1.0F);
+    SDL_RenderClear(window.renderer);
+    ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), window.renderer);
+    SDL_RenderPresent(window.renderer);
+    end_phase("backend");
+
+    phase_start = frame_start;
+    end_phase("frame");
+}
+
+// Draws frames until `done` (or MAX_WAIT_FRAMES); false on timeout
+template <typename DoneFn>
+bool wait_frames(const Window& window, DoneFn done, FrameSamples* samples) {
+    for (size_t frame = 0; frame < MAX_WAIT_FRAMES; frame++) {
+        if (done()) {
+            return true;
+        }
+        draw_frame(window, 0.0F, samples);
+    }
+    return false;
+}
+
+bool replay(const Window& window, const std::vector<Command>& commands, FrameSamples& samples) {
+    for (const Command& command : commands) {
+        if (command.name == "frames") {
+            for (size_t i = 0; i < command.frames; i++) {
+                draw_frame(window, 0.0F, &samples);
+            }
+        } else if (command.name == "scroll") {
+            for (size_t i = 0; i < command.frames; i++) {
+                // Positive trace notches scroll down; ImGui's wheel is positive upwards
+                draw_frame(window, -static_cast<float>(command.value), &samples);
+            }
+        } else if (command.name == "jump") {
+            script_viewer_jump(command.value);
+            draw_frame(window, 0.0F, &samples);
+        } else if (command.name == "expand" || command.name == "collapse") {
+            script_viewer_set_open(command.frames, command.name == "expand");
+            draw_frame(window, 0.0F, &samples);
+        } else if (command.name == "search") {
+            script_viewer_search(command.text);
+            draw_frame(window, 0.0F, &samples);
+        } else if (command.name == "wait_search") {
+            if (!wait_frames(window, []() { return !viewer_search_in_progress(); }, &samples)) {
+                std::fprintf(stderr, "error: search did not finish\n");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Nearest-rank percentile of unsorted samples
+double percentile(std::vector<double> values, double fraction) {
+    std::sort(values.begin(), values.end());
+    auto rank = static_cast<size_t>(fraction * static_cast<double>(values.size()));
+    return values[std::min(rank, values.size() - 1)];
+}
+
+void write_report(std::FILE* out, const std::string& file_path, const FrameSamples& samples) {
+    size_t frames = samples.samples.empty() ? 0 : samples.samples[0].size();
+    std::fprintf(stderr, "%-28s %9s %9s %9s\n", "phase", "p50 ms", "p99 ms", "max ms");
+    std::fprintf(out, "{\n  \"file\": %s,\n  \"frames\": %zu,\n  \"phases\": [",
+                 json_string(file_path).c_str(), frames);
+    for (size_t i = 0; i < samples.names.size(); i++) {
+        const std::vector<double>& values = samples.samples[i];
+        double p50 = percentile(values, 0.50);
+        double p99 = percentile(values, 0.99);
+        double max = *std::max_element(values.begin(), values.end());
+        std::fprintf(stderr, "%-28s %9.3f %9.3f %9.3f\n", samples.names[i].c_str(), p50, p99,
+                     max);
+        std::fprintf(out,
+                     "%s\n    {\"name\": %s, \"p50_ms\": %.4f, \"p99_ms\": %.4f, "
+                     "\"max_ms\": %.4f}",
+                     i == 0 ? "" : ",", json_string(samples.names[i]).c_str(), p50, p99, max);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+int run(const std::string& file_path, const std::vector<Command>& commands,
+        const std::string& output_path) {
+    Window window;
+    if (!create_window(window)) {
+        destroy_window(window);
+        return 1;
+    }
+    PanelManager::instance().set_timing_enabled(true);
+
+    // Load while drawing (unrecorded) frames, as the app would
+    set_load_summary_output(true);
+    start_json_load(file_path);
+    wait_frames(window, []() { return !json_load_in_progress(); }, nullptr);
+    draw_frame(window, 0.0F, nullptr); // Let the viewer pick up the new dataset
+    if (!get_json_data().is_ready()) {
+        std::fprintf(stderr, "error: %s: %s\n", file_path.c_str(),
+                     get_loading_state().error_message.c_str());
+        destroy_window(window);
+        return 1;
+    }
+
+    FrameSamples samples;
+    bool replayed = replay(window, commands, samples);
+    get_job_system().shutdown();
+    destroy_window(window);
+    if (!replayed || samples.samples.empty()) {
+        return 1;
+    }
+
+    std::FILE* out = output_path.empty() ? stdout : std::fopen(output_path.c_str(), "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot open %s\n", output_path.c_str());
+        return 1;
+    }
+    write_report(out, file_path, samples);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
+} // namespace
+
+int run_frame_bench(const std::vector<std::string>& args) {
+    std::vector<std::string> positional;
+    std::string output_path;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "-o" && i + 1 < args.size()) {
+            output_path = args[++i];
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+    if (positional.empty() || positional.size() > 2) {
+        std::fputs("usage: main --bench-frames FILE [TRACE] [-o PATH]\n", stderr);
+        return 2;
+    }
+
+    std::optional<std::vector<Command>> commands;
+    if (positional.size() == 2) {
+        std::ifstream trace(positional[1]);
+        if (!trace) {
+            std::fprintf(stderr, "error: cannot open %s\n", positional[1].c_str());
+            return 1;
+        }
+        commands = parse_trace(trace);
+    } else {
+        std::istringstream trace(DEFAULT_TRACE);
+        commands = parse_trace(trace);
+    }
+    if (!commands) {
+        return 2;
+    }
+    return run(positional[0], *commands, output_path);
+}
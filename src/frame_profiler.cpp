@@ -0,0 +1,54 @@
+#include "frame_profiler.hpp"
+
+#include "panel_manager.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+constexpr std::array<const char*, FRAME_PHASE_COUNT> PHASE_NAMES = {
+    "events", "new_frame", "panels", "scheduler", "render", "backend", "present"};
+} // namespace
+
+const char* frame_phase_name(FramePhase phase) {
+    auto slot = static_cast<size_t>(phase);
+    return slot < FRAME_PHASE_COUNT ? PHASE_NAMES[slot] : "none";
+}
+
+FrameProfiler& FrameProfiler::instance() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler& get_frame_profiler() {
+    return FrameProfiler::instance();
+}
+
+void FrameProfiler::set_enabled(bool enabled) {
+    if (enabled && !enabled_) {
+        next_ = 0;
+        count_ = 0;
+    }
+    enabled_ = enabled;
+    in_frame_ = false; // A frame already under way was not timed from its start
+    PanelManager::instance().set_timing_enabled(enabled);
+}
+
+void FrameProfiler::end_frame() {
+    if (!in_frame_) {
+        return;
+    }
+    in_frame_ = false;
+
+    const std::vector<PanelManager::PanelTiming>& timings =
+        PanelManager::instance().last_frame_timings();
+    size_t panel_count = std::min(timings.size(), MAX_PANELS);
+    for (size_t i = 0; i < panel_count; i++) {
+        current_.panel_ms[i] = static_cast<float>(timings[i].seconds * 1000.0);
+    }
+    current_.total_ms = to_ms(Clock::now() - frame_start_);
+
+    frames_[next_] = current_;
+    next_ = (next_ + 1) % HISTORY;
+    count_ = std::min(count_ + 1, HISTORY);
+}
@@ -0,0 +1,260 @@
+#include "headless_cli.hpp"
+
+#include "utils/document_search.hpp"
+#include "utils/index_file.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
+#include "utils/json_parser.hpp"
+#include "utils/loading_state.hpp"
+#include "utils/memory_stats.hpp"
+#include "utils/parallel_search.hpp"
+#include "utils/result_set.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace {
+constexpr size_t OUTPUT_BUFFER_SIZE = 1024ULL * 1024ULL; // 1MB stdio buffer
+constexpr size_t GREP_CONTEXT_BYTES = 40;                // Shown on each side of a grep match
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+constexpr int EXIT_ERROR = 1;
+constexpr int EXIT_USAGE = 2;
+
+constexpr const char* USAGE = "usage: main --headless index FILE\n"
+                              "       main --headless count|grep|filter FILE TEXT\n"
+                              "       main --headless export FILE [TEXT]\n"
+                              "options: -o PATH  write output to PATH instead of stdout\n";
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string command;
+    std::string file_path;
+    std::optional<std::string> text;
+    std::string output_path; // Empty: stdout
+};
+
+std::optional<Options> parse_args(const std::vector<std::string>& args) {
+    Options options;
+    std::vector<std::string> positional;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "-o") {
+            if (i + 1 >= args.size()) {
+                return std::nullopt;
+            }
+            options.output_path = args[++i];
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+    if (positional.size() < 2 || positional.size() > 3) {
+        return std::nullopt;
+    }
+    options.command = positional[0];
+    options.file_path = positional[1];
+    if (positional.size() == 3) {
+        options.text = positional[2];
+    }
+
+    const std::string& command = options.command;
+    bool needs_text = command == "count" || command == "grep" || command == "filter";
+    bool takes_text = needs_text || command == "export";
+    if (command != "index" && !takes_text) {
+        return std::nullopt;
+    }
+    if ((needs_text && !options.text) || (!takes_text && options.text) ||
+        (options.text && options.text->empty())) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report_throughput(const char* phase, size_t bytes, double seconds) {
+    double megabytes = static_cast<double>(bytes) / BYTES_PER_MB;
+    double rate = seconds > 0.0 ? megabytes / seconds : 0.0;
+    std::fprintf(stderr, "%s: %.1f MB in %.3f s (%.1f MB/s)\n", phase, megabytes, seconds, rate);
+}
+
+// Fully buffered stdout or file sink that counts what it writes
+class Output {
+public:
+    Output() = default;
+    Output(const Output&) = delete;
+    Output& operator=(const Output&) = delete;
+    ~Output() {
+        if (file_ != nullptr && file_ != stdout) {
+            std::fclose(file_);
+        }
+    }
+
+    bool open(const std::string& path) {
+        file_ = path.empty() ? stdout : std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        std::setvbuf(file_, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+        return true;
+    }
+
+    void write(std::string_view data) {
+        std::fwrite(data.data(), 1, data.size(), file_);
+        bytes_ += data.size();
+    }
+
+    bool finish() { return std::fflush(file_) == 0 && std::ferror(file_) == 0; }
+    size_t bytes_written() const { return bytes_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    size_t bytes_ = 0;
+};
+
+// Loads through the same path as the UI (including the sidecar index)
+bool load(const std::string& file_path) {
+    Clock::time_point start = Clock::now();
+    json_parser(file_path);
+
+    LoadingState& state = get_loading_state();
+    if (!get_json_data().is_ready()) {
+        const std::string& error = state.error_message;
+        std::fprintf(stderr, "error: %s\n", error.empty() ? "could not load file" : error.c_str());
+        return false;
+    }
+    if (!state.error_message.empty()) {
+        std::fprintf(stderr, "warning: %s\n", state.error_message.c_str());
+    }
+    report_throughput("load", get_json_data().snapshot().raw_size(), seconds_since(start));
+    std::fprintf(stderr, "%s\n", state.status_message.c_str());
+    return true;
+}
+
+SearchResults search(const DatasetSnapshot& snapshot, const std::string& text) {
+    Clock::time_point start = Clock::now();
+    SearchResults results;
+    ParallelSearch parallel_search({SearchKind::Substring, text}, snapshot, JobPriority::High);
+    parallel_search.wait();
+    parallel_search.collect(results, std::numeric_limits<size_t>::max());
+
+    report_throughput("search", snapshot.raw_size(), seconds_since(start));
+    std::fprintf(stderr, "%llu matching documents\n",
+                 static_cast<unsigned long long>(results.matches.size()));
+    return results;
+}
+
+// One line per match: document index, byte offset and the surrounding bytes
+void write_grep(Output& output, const DatasetSnapshot& snapshot, const SearchResults& results,
+                const SearchQuery& query) {
+    std::pmr::vector<uint64_t> scanned_offsets;
+    std::string line;
+    for (uint64_t doc_index : results.matches) {
+        std::string_view document = snapshot.document(doc_index);
+        std::span<const uint64_t> offsets = results.offsets.find(doc_index);
+        if (!results.offsets.is_recorded(doc_index)) {
+            // Offsets past MatchOffsets' cap are found again
+            scanned_offsets.clear();
+            find_matches(query, document, scanned_offsets);
+            offsets = scanned_offsets;
+        }
+        for (uint64_t offset : offsets) {
+            size_t begin = offset - std::min<size_t>(offset, GREP_CONTEXT_BYTES);
+            size_t end = std::min(document.size(),
+                                  offset + match_length(query) + GREP_CONTEXT_BYTES);
+            line = std::to_string(doc_index) + ':' + std::to_string(offset) + ':';
+            for (char byte : document.substr(begin, end - begin)) {
+                line.push_back(byte == '\n' || byte == '\r' ? ' ' : byte);
+            }
+            line.push_back('\n');
+            output.write(line);
+        }
+    }
+}
+
+int run(const Options& options) {
+    if (!load(options.file_path)) {
+        return EXIT_ERROR;
+    }
+    DatasetSnapshot snapshot = get_json_data().snapshot();
+
+    Output output;
+    if (!output.open(options.output_path)) {
+        std::fprintf(stderr, "error: cannot open %s\n", options.output_path.c_str());
+        return EXIT_ERROR;
+    }
+
+    SearchQuery query;
+    ResultSet selected = ResultSet::all(snapshot.document_count());
+    SearchResults results;
+    if (options.text) {
+        query.text = *options.text;
+        results = search(snapshot, query.text);
+        selected = results.matches;
+    }
+
+    Clock::time_point write_start = Clock::now();
+    const std::string& command = options.command;
+    if (command == "index") {
+        if (!save_index_file(options.file_path, snapshot)) {
+            std::fprintf(stderr, "error: cannot write %s\n",
+                         index_file_path(options.file_path).c_str());
+            return EXIT_ERROR;
+        }
+        report_throughput("index persist", snapshot.index().size_bytes(),
+                          seconds_since(write_start));
+        std::fprintf(stderr, "index: wrote %s\n", index_file_path(options.file_path).c_str());
+        output.write(std::to_string(snapshot.document_count()) + '\n');
+    } else if (command == "count") {
+        output.write(std::to_string(results.matches.size()) + '\n');
+    } else if (command == "grep") {
+        write_grep(output, snapshot, results, query);
+    } else if (command == "filter") {
+        for (uint64_t doc_index : selected) {
+            output.write(snapshot.document(doc_index));
+            output.write("\n");
+        }
+    } else if (command == "export") {
+        // One formatting buffer reused across documents
+        std::pmr::unsynchronized_pool_resource pool;
+        for (uint64_t doc_index : selected) {
+            FormattedJson formatted = format_json(snapshot.document(doc_index), true, &pool);
+            output.write(formatted.text);
+            output.write("\n");
+        }
+    }
+
+    if (!output.finish()) {
+        std::fprintf(stderr, "error: write failed\n");
+        return EXIT_ERROR;
+    }
+    report_throughput("write", output.bytes_written(), seconds_since(write_start));
+    // Taken while the dataset and search results are still alive
+    MemoryReport memory = memory_report();
+    memory.items.push_back({"search_results", results.memory_bytes()});
+    memory.accounted_bytes += results.memory_bytes();
+    std::fprintf(stderr, "%s\n", memory_report_json(memory).c_str());
+    return 0;
+}
+} // namespace
+
+int run_headless(const std::vector<std::string>& args) {
+    std::optional<Options> options = parse_args(args);
+    if (!options) {
+        std::fputs(USAGE, stderr);
+        return EXIT_USAGE;
+    }
+    set_load_summary_output(true);
+    int exit_code = run(*options);
+    get_job_system().shutdown();
+    return exit_code;
+}
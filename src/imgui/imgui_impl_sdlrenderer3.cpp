@@ -48,6 +48,13 @@
 #include "imgui/imgui_impl_sdlrenderer3.h"
 #include <stdint.h> // intptr_t
 
+// SSE2 is part of the x86-64 baseline; 32-bit x86 needs it enabled explicitly
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMGUI_IMPL_SDLRENDERER3_SSE2
+#include <emmintrin.h>
+#endif
+
 // Clang warnings with -Weverything
 #if defined(__clang__)
 #pragma clang diagnostic push
@@ -143,25 +150,41 @@ void ImGui_ImplSDLRenderer3_NewFrame() {
 }
 
 // https://github.com/libsdl-org/SDL/issues/9009
-static int SDL_RenderGeometryRaw8BitColor(
-    SDL_Renderer *renderer, ImVector<SDL_FColor> &colors_out,
-    SDL_Texture *texture, const float *xy, int xy_stride,
-    const SDL_Color *color, int color_stride, const float *uv, int uv_stride,
-    int num_vertices, const void *indices, int num_indices, int size_indices) {
-  const Uint8 *color2 = (const Uint8 *)color;
-  colors_out.resize(num_vertices);
-  SDL_FColor *color3 = colors_out.Data;
-  for (int i = 0; i < num_vertices; i++) {
-    color3[i].r = color->r / 255.0f;
-    color3[i].g = color->g / 255.0f;
-    color3[i].b = color->b / 255.0f;
-    color3[i].a = color->a / 255.0f;
-    color2 += color_stride;
-    color = (const SDL_Color *)color2;
+// SDL_RenderGeometryRaw() only takes float colors, so every vertex color is
+// converted from 8-bit. This is done once per draw list (rather than once per
+// draw command over the rest of the list), four vertices at a time with SSE2.
+static void ImGui_ImplSDLRenderer3_ConvertColors(const ImDrawVert *vtx,
+                                                 int num_vertices,
+                                                 SDL_FColor *colors_out) {
+  static_assert(sizeof(SDL_FColor) == 4 * sizeof(float),
+                "SDL_FColor must be four packed floats");
+  int i = 0;
+#ifdef IMGUI_IMPL_SDLRENDERER3_SSE2
+  const __m128 max4 = _mm_set1_ps(255.0f);
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= num_vertices; i += 4) {
+    // ImDrawVert::col is RGBA in memory, same as SDL_Color
+    __m128i rgba8 = _mm_set_epi32((int)vtx[i + 3].col, (int)vtx[i + 2].col,
+                                  (int)vtx[i + 1].col, (int)vtx[i + 0].col);
+    __m128i lo16 = _mm_unpacklo_epi8(rgba8, zero);
+    __m128i hi16 = _mm_unpackhi_epi8(rgba8, zero);
+    float *dst = &colors_out[i].r;
+    const __m128i rgba32[4] = {
+        _mm_unpacklo_epi16(lo16, zero), _mm_unpackhi_epi16(lo16, zero),
+        _mm_unpacklo_epi16(hi16, zero), _mm_unpackhi_epi16(hi16, zero)};
+    for (int v = 0; v < 4; v++)
+      _mm_storeu_ps(dst + v * 4, _mm_div_ps(_mm_cvtepi32_ps(rgba32[v]), max4));
+  }
+#endif
+  for (; i < num_vertices; i++) {
+    const SDL_Color *color =
+        (const SDL_Color *)(const void *)((const char *)(vtx + i) +
+                                          offsetof(ImDrawVert, col));
+    colors_out[i].r = color->r / 255.0f;
+    colors_out[i].g = color->g / 255.0f;
+    colors_out[i].b = color->b / 255.0f;
+    colors_out[i].a = color->a / 255.0f;
   }
-  return SDL_RenderGeometryRaw(renderer, texture, xy, xy_stride, color3,
-                               sizeof(*color3), uv, uv_stride, num_vertices,
-                               indices, num_indices, size_indices);
 }
 
 void ImGui_ImplSDLRenderer3_RenderDrawData(ImDrawData *draw_data,
@@ -226,6 +249,9 @@ void ImGui_ImplSDLRenderer3_RenderDrawData(ImDrawData *draw_data,
   for (const ImDrawList *draw_list : draw_data->CmdLists) {
     const ImDrawVert *vtx_buffer = draw_list->VtxBuffer.Data;
     const ImDrawIdx *idx_buffer = draw_list->IdxBuffer.Data;
+    bd->ColorBuffer.resize(draw_list->VtxBuffer.Size);
+    ImGui_ImplSDLRenderer3_ConvertColors(vtx_buffer, draw_list->VtxBuffer.Size,
+                                         bd->ColorBuffer.Data);
 
     for (int cmd_i = 0; cmd_i < draw_list->CmdBuffer.Size; cmd_i++) {
       const ImDrawCmd *pcmd = &draw_list->CmdBuffer[cmd_i];
@@ -271,19 +297,16 @@ void ImGui_ImplSDLRenderer3_RenderDrawData(ImDrawData *draw_data,
             (const float *)(const void *)((const char *)(vtx_buffer +
                                                          pcmd->VtxOffset) +
                                           offsetof(ImDrawVert, uv));
-        const SDL_Color *color =
-            (const SDL_Color *)(const void *)((const char *)(vtx_buffer +
-                                                             pcmd->VtxOffset) +
-                                              offsetof(ImDrawVert,
-                                                       col)); // SDL 2.0.19+
+        const SDL_FColor *color = bd->ColorBuffer.Data + pcmd->VtxOffset;
 
         // Bind texture, Draw
         SDL_Texture *tex = (SDL_Texture *)pcmd->GetTexID();
-        SDL_RenderGeometryRaw8BitColor(
-            renderer, bd->ColorBuffer, tex, xy, (int)sizeof(ImDrawVert), color,
-            (int)sizeof(ImDrawVert), uv, (int)sizeof(ImDrawVert),
-            draw_list->VtxBuffer.Size - pcmd->VtxOffset,
-            idx_buffer + pcmd->IdxOffset, pcmd->ElemCount, sizeof(ImDrawIdx));
+        SDL_RenderGeometryRaw(renderer, tex, xy, (int)sizeof(ImDrawVert), color,
+                              (int)sizeof(SDL_FColor), uv,
+                              (int)sizeof(ImDrawVert),
+                              draw_list->VtxBuffer.Size - pcmd->VtxOffset,
+                              idx_buffer + pcmd->IdxOffset, pcmd->ElemCount,
+                              sizeof(ImDrawIdx));
       }
     }
   }
@@ -1,10 +1,22 @@
+#include "frame_bench.hpp"
+#include "frame_profiler.hpp"
+#include "headless_cli.hpp"
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_sdl3.h"
 #include "imgui/imgui_impl_sdlrenderer3.h"
 #include "panel_manager.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_parser.hpp"
+#include "utils/trace.hpp"
+#include "utils/ui_wake.hpp"
 
 #include <SDL3/SDL.h>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 
 constexpr int WINDOW_WIDTH = 800;
 constexpr int WINDOW_HEIGHT = 800;
@@ -12,11 +24,105 @@ constexpr float CLEAR_R = 0.45F;
 constexpr float CLEAR_G = 0.55F;
 constexpr float CLEAR_B = 0.60F;
 constexpr float CLEAR_A = 1.00F;
+// Frames rendered after any event, so hover/click state settles before idling
+constexpr int ACTIVE_FRAMES = 3;
+// Longest idle wait; a safety net for state that changes without an event
+constexpr Sint32 IDLE_TIMEOUT_MS = 500;
+// Refresh interval assumed when the display does not report one (60 Hz)
+constexpr Uint64 DEFAULT_FRAME_NS = 16666667;
+
+// Posted by request_ui_wake() from background threads
+static Uint32 wake_event_type = 0;
+
+// Hash of everything the renderer would draw, to skip presenting a frame
+// identical to the last one. Returns 0 (never matches) when the frame must be
+// drawn regardless: textures pending upload or user callbacks.
+static uint64_t hash_draw_data(const ImDrawData *draw_data) {
+  uint64_t hash = 0x9E3779B97F4A7C15ULL;
+  auto mix = [&hash](const void *data, size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+      uint64_t word = 0;
+      std::memcpy(&word, bytes + offset, sizeof(word));
+      hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+      hash ^= hash >> 31;
+    }
+    for (; offset < size; offset++) {
+      hash = (hash ^ bytes[offset]) * 0x94D049BB133111EBULL;
+    }
+  };
+
+  if (draw_data->Textures != nullptr) {
+    for (const ImTextureData *texture : *draw_data->Textures) {
+      if (texture->Status != ImTextureStatus_OK) {
+        return 0;
+      }
+    }
+  }
+  mix(&draw_data->DisplayPos, sizeof(ImVec2));
+  mix(&draw_data->DisplaySize, sizeof(ImVec2));
+  mix(&draw_data->FramebufferScale, sizeof(ImVec2));
+  for (const ImDrawList *draw_list : draw_data->CmdLists) {
+    mix(draw_list->VtxBuffer.Data, draw_list->VtxBuffer.size_in_bytes());
+    mix(draw_list->IdxBuffer.Data, draw_list->IdxBuffer.size_in_bytes());
+    for (const ImDrawCmd &cmd : draw_list->CmdBuffer) {
+      if (cmd.UserCallback != nullptr) {
+        return 0;
+      }
+      mix(&cmd.ClipRect, sizeof(cmd.ClipRect));
+      mix(&cmd.TexRef._TexData, sizeof(cmd.TexRef._TexData));
+      mix(&cmd.TexRef._TexID, sizeof(cmd.TexRef._TexID));
+      mix(&cmd.VtxOffset, sizeof(cmd.VtxOffset));
+      mix(&cmd.IdxOffset, sizeof(cmd.IdxOffset));
+      mix(&cmd.ElemCount, sizeof(cmd.ElemCount));
+    }
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+// Common exit path: stops background jobs (a load may already be running),
+// then writes the trace started from JSON_VIEWER_TRACE, if any
+static int finish_run(bool tracing, int exit_code) {
+  get_job_system().shutdown();
+  if (tracing && !write_trace(trace_output_path())) {
+    std::cerr << "Error: cannot write trace " << trace_output_path() << "\n";
+  }
+  return exit_code;
+}
+
+// One refresh interval of the display the window is on
+static Uint64 display_frame_ns(SDL_Window *window) {
+  const SDL_DisplayMode *mode =
+      SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+  if (mode == nullptr || mode->refresh_rate <= 0.0F) {
+    return DEFAULT_FRAME_NS;
+  }
+  return static_cast<Uint64>(1e9 / static_cast<double>(mode->refresh_rate));
+}
+
+int main(int argc, char *argv[]) {
+  bool tracing = start_trace_from_environment();
+  trace_thread_name("main");
+
+  // Scripted use: no window, no SDL
+  if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+    return finish_run(
+        tracing, run_headless(std::vector<std::string>(argv + 2, argv + argc)));
+  }
+  if (argc > 1 && std::strcmp(argv[1], "--bench-frames") == 0) {
+    return finish_run(
+        tracing, run_frame_bench(std::vector<std::string>(argv + 2, argv + argc)));
+  }
+
+  // `main FILE`: read and index on a worker while the window comes up
+  if (argc > 1) {
+    start_json_load(argv[1]);
+  }
 
-int main() {
   if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD)) {
     std::cerr << "Error: SDL_Init(): " << SDL_GetError() << "\n";
-    return 1;
+    return finish_run(tracing, 1);
   }
 
   float main_scale = SDL_GetDisplayContentScale(SDL_GetPrimaryDisplay());
@@ -27,15 +133,18 @@ int main() {
       static_cast<int>(WINDOW_HEIGHT * main_scale), window_flags);
   if (window == nullptr) {
     std::cerr << "Error: SDL_CreateWindow(): " << SDL_GetError() << "\n";
-    return 1;
+    SDL_Quit();
+    return finish_run(tracing, 1);
   }
 
   SDL_Renderer *renderer = SDL_CreateRenderer(window, nullptr);
-  SDL_SetRenderVSync(renderer, 1);
   if (renderer == nullptr) {
     std::cerr << "Error: SDL_CreateRenderer(): " << SDL_GetError() << "\n";
-    return 1;
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return finish_run(tracing, 1);
   }
+  SDL_SetRenderVSync(renderer, 1);
   SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
   SDL_ShowWindow(window);
 
@@ -56,10 +165,38 @@ int main() {
 
   ImVec4 clear_color = ImVec4(CLEAR_R, CLEAR_G, CLEAR_B, CLEAR_A);
 
+  // Background jobs wake the loop through an SDL event while it idles
+  wake_event_type = SDL_RegisterEvents(1);
+  set_ui_wake_callback([]() {
+    SDL_Event wake_event{};
+    wake_event.type = wake_event_type;
+    SDL_PushEvent(&wake_event);
+  });
+
   bool done = false;
+  int active_frames = ACTIVE_FRAMES;
+  uint64_t presented_hash = 0;
+  FrameProfiler &profiler = get_frame_profiler();
   while (!done) {
+    // Block while idle: input, a wake-up from a background job or the timeout
+    // resumes the loop
     SDL_Event event;
-    while (SDL_PollEvent(&event)) {
+    bool idle = active_frames == 0 && !get_frame_scheduler().wants_next_frame();
+    bool has_event = idle ? SDL_WaitEventTimeout(&event, IDLE_TIMEOUT_MS)
+                          : SDL_PollEvent(&event);
+    Uint64 frame_start_ns = SDL_GetTicksNS();
+    get_frame_scheduler().begin_frame();
+    profiler.begin_frame();
+    TRACE_SCOPE("frame");
+
+    bool force_present = false;
+    for (; has_event; has_event = SDL_PollEvent(&event)) {
+      // A wake-up needs just this frame; input keeps rendering a few more
+      if (event.type == wake_event_type) {
+        acknowledge_ui_wake();
+        continue;
+      }
+      active_frames = ACTIVE_FRAMES;
       ImGui_ImplSDL3_ProcessEvent(&event);
       if (event.type == SDL_EVENT_QUIT) {
         done = true;
@@ -68,7 +205,16 @@ int main() {
           event.window.windowID == SDL_GetWindowID(window)) {
         done = true;
       }
+      // The window contents may have been lost: present even an unchanged frame
+      if (event.type >= SDL_EVENT_WINDOW_FIRST &&
+          event.type <= SDL_EVENT_WINDOW_LAST) {
+        force_present = true;
+      }
+    }
+    if (active_frames > 0) {
+      active_frames--;
     }
+    profiler.mark(FramePhase::Events);
 
     if (SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED) {
       SDL_Delay(10);
@@ -78,19 +224,53 @@ int main() {
     ImGui_ImplSDLRenderer3_NewFrame();
     ImGui_ImplSDL3_NewFrame();
     ImGui::NewFrame();
+    PanelManager::instance().begin_frame();
+    profiler.mark(FramePhase::NewFrame);
 
     PanelManager::instance().draw_all();
+    profiler.mark(FramePhase::Panels);
+
+    // Incremental work (search, ...) gets whatever is left of the frame budget
+    get_frame_scheduler().run_frame();
+    profiler.mark(FramePhase::Scheduler);
 
     ImGui::Render();
+
+    // Nothing changed on screen: skip the draw and present entirely
+    uint64_t frame_hash = hash_draw_data(ImGui::GetDrawData());
+    profiler.mark(FramePhase::Render);
+    if (frame_hash != 0 && frame_hash == presented_hash && !force_present) {
+      profiler.end_frame();
+      // No present means no vsync wait: sleep out the rest of the refresh
+      // interval instead of spinning (an event ends the wait early)
+      Uint64 elapsed_ns = SDL_GetTicksNS() - frame_start_ns;
+      Uint64 frame_ns = display_frame_ns(window);
+      if (elapsed_ns < frame_ns) {
+        SDL_WaitEventTimeout(
+            nullptr, static_cast<Sint32>((frame_ns - elapsed_ns) / 1000000));
+      }
+      continue;
+    }
+    presented_hash = frame_hash;
+
     SDL_SetRenderScale(renderer, imgui_io.DisplayFramebufferScale.x,
                        imgui_io.DisplayFramebufferScale.y);
     SDL_SetRenderDrawColorFloat(renderer, clear_color.x, clear_color.y,
                                 clear_color.z, clear_color.w);
     SDL_RenderClear(renderer);
     ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(), renderer);
+    profiler.mark(FramePhase::Backend);
+    trace_begin("present");
     SDL_RenderPresent(renderer);
+    trace_end("present");
+    profiler.mark(FramePhase::Present);
+    profiler.end_frame();
   }
 
+  // Stop background loads/searches before the data they use is destroyed
+  get_job_system().shutdown();
+  set_ui_wake_callback(nullptr);
+
   ImGui_ImplSDLRenderer3_Shutdown();
   ImGui_ImplSDL3_Shutdown();
   ImGui::DestroyContext();
@@ -99,5 +279,5 @@ int main() {
   SDL_DestroyWindow(window);
   SDL_Quit();
 
-  return 0;
+  return finish_run(tracing, 0);
 }
@@ -10,7 +10,6 @@
 #include <cstring>
 #include <imgui/imgui.h>
 #include <string>
-#include <thread>
 
 namespace {
 constexpr int PATH_BUFFER_SIZE = 512;
@@ -27,12 +26,6 @@ void file_dialog_callback(void* userdata, const char* const* filelist, int /*fil
         path_buffer->at(PATH_BUFFER_SIZE - 1) = '\0';
     }
 }
-
-void start_parsing_thread(const std::string& path) {
-    // Detached thread for background parsing
-    std::thread parser_thread([path]() { json_parser(path); });
-    parser_thread.detach();
-}
 } // namespace
 
 void draw_file_chooser_panel() {
@@ -69,7 +62,7 @@ void draw_file_chooser_panel() {
     if (ImGui::Button("Open", ImVec2(BUTTON_WIDTH, 0.0F))) {
         std::string path = path_buffer.data();
         if (!path.empty()) {
-            start_parsing_thread(path);
+            start_json_load(path);
         }
     }
 
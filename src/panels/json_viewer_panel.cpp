@@ -1,91 +1,249 @@
 #include "panels/json_viewer_panel.hpp"
 
 #include "panel_manager.hpp"
+#include "utils/document_formatter.hpp"
+#include "utils/document_search.hpp"
+#include "utils/frame_scheduler.hpp"
+#include "utils/height_index.hpp"
 #include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
 #include "utils/json_parser.hpp"
+#include "utils/loading_state.hpp"
+#include "utils/memory_stats.hpp"
+#include "utils/parallel_search.hpp"
+#include "utils/prefetcher.hpp"
+#include "utils/query_cache.hpp"
+#include "utils/result_set.hpp"
+#include "utils/scroll_anchor.hpp"
 
 #include <SDL3/SDL.h>
 #include <imgui/imgui.h>
-#include <simdjson.h>
+#include <imgui/imgui_internal.h>
 
 #include <algorithm>
 #include <array>
 #include <cfloat>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
-#include <sstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
 
 constexpr int SEARCH_BUFFER_SIZE = 256;
 constexpr float TOOLBAR_BUTTON_WIDTH = 100.0F;
-constexpr size_t SEARCH_BATCH_SIZE = 1000; // Documents to search per frame
-
-// Pretty-print JSON with indentation
-std::string format_json(const std::string& raw_json) {
-    simdjson::dom::parser parser;
-    auto doc = parser.parse(raw_json);
-    if (doc.error() != simdjson::SUCCESS) {
-        return raw_json; // Return as-is if parsing fails
+constexpr float COMBINE_COMBO_WIDTH = 110.0F;
+constexpr float MATCH_SCROLL_RATIO = 0.3F; // Where a jumped-to match lands in the list view
+constexpr double WHEEL_SCROLL_ROWS = 5.0;   // Collapsed rows per mouse wheel notch
+// Larger documents skip the text widget and draw only their visible lines
+constexpr size_t SELECTABLE_TEXT_LIMIT = 1024ULL * 1024ULL;
+constexpr ImU32 MATCH_HIGHLIGHT_COLOR = IM_COL32(255, 220, 0, 70);
+constexpr ImU32 ACTIVE_MATCH_COLOR = IM_COL32(255, 140, 0, 150);
+
+// How a finished search is merged with the current result set
+enum class CombineMode : uint8_t { Replace, And, Or, AndNot };
+constexpr std::array<const char*, 4> COMBINE_MODE_LABELS = {"New search", "AND", "OR",
+                                                             "AND NOT"};
+
+ResultSet combine_results(const ResultSet& current, const ResultSet& matches, CombineMode mode) {
+    switch (mode) {
+    case CombineMode::Replace:
+        return matches;
+    case CombineMode::And:
+        return current & matches;
+    case CombineMode::Or:
+        return current | matches;
+    case CombineMode::AndNot:
+        return current - matches;
     }
+    return matches;
+}
 
-    std::ostringstream oss;
-    oss << simdjson::to_string(doc.value());
+std::string describe_search(const std::string& query, bool negate) {
+    return (negate ? "NOT \"" : "\"") + query + "\"";
+}
 
-    // simdjson::to_string produces minified JSON, so we need to pretty-print
-    std::string minified = oss.str();
-    std::ostringstream formatted;
+// Scripted interaction waiting for the next frame (see script_viewer_search())
+struct ViewerScript {
+    std::optional<std::string> search;
+    size_t toggle_rows = 0;
+    bool toggle_open = false;
+    std::optional<double> jump_fraction;
+    bool search_running = false; // Mirrors the panel's search state for viewer_search_in_progress()
+};
+ViewerScript viewer_script;
+
+using MatchRanges = std::pmr::vector<std::pair<size_t, size_t>>;
+
+// Pretty-printed [start, end) of each match in a formatted document
+MatchRanges map_matches(const FormattedJson& formatted, std::span<const uint64_t> raw_offsets,
+                        size_t length, std::pmr::memory_resource* memory) {
+    MatchRanges matches(memory);
+    matches.reserve(raw_offsets.size());
+    for (uint64_t offset : raw_offsets) {
+        size_t begin = formatted.positions.to_pretty(offset);
+        size_t end = length > 0 ? formatted.positions.to_pretty(offset + length - 1) + 1 : begin;
+        matches.emplace_back(begin, end);
+    }
+    return matches;
+}
 
-    int indent = 0;
-    bool in_string = false;
-    constexpr int INDENT_SIZE = 2;
+// Draws match highlights for a text whose first glyph is at `text_origin`, clipped to
+// `frame_min`..`frame_max`. Call before the text is drawn so they sit behind it.
+// Only matches on lines inside the clip rect are drawn.
+void draw_match_highlights(const FormattedJson& formatted, const MatchRanges& matches,
+                           size_t active_match, ImVec2 text_origin, ImVec2 frame_min,
+                           ImVec2 frame_max) {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    draw_list->PushClipRect(frame_min, frame_max, true);
+    ImVec2 clip_min = draw_list->GetClipRectMin();
+    ImVec2 clip_max = draw_list->GetClipRectMax();
+    float line_height = ImGui::GetTextLineHeight();
+
+    float first_visible = std::max(0.0F, (clip_min.y - text_origin.y) / line_height);
+    float last_visible = (clip_max.y - text_origin.y) / line_height;
+    if (last_visible < 0.0F) {
+        draw_list->PopClipRect();
+        return;
+    }
+    auto first_line = std::min(static_cast<size_t>(first_visible), formatted.line_count() - 1);
+    auto last_line = std::min(static_cast<size_t>(last_visible), formatted.line_count() - 1);
+
+    // Matches are sorted, so skip straight to the first visible one
+    auto iter = std::lower_bound(
+        matches.begin(), matches.end(), formatted.line_starts[first_line],
+        [](const std::pair<size_t, size_t>& match, size_t pos) { return match.first < pos; });
+
+    const char* text = formatted.text.c_str();
+    for (; iter != matches.end(); ++iter) {
+        size_t line = formatted.line_of(iter->first);
+        if (line > last_line) {
+            break;
+        }
+        size_t line_start = formatted.line_starts[line];
+        size_t line_end = line + 1 < formatted.line_count() ? formatted.line_starts[line + 1] - 1
+                                                            : formatted.text.size();
+        size_t match_end = std::min(iter->second, line_end);
+
+        float x_begin = ImGui::CalcTextSize(text + line_start, text + iter->first).x;
+        float x_end = x_begin + ImGui::CalcTextSize(text + iter->first, text + match_end).x;
+        float y_top = text_origin.y + static_cast<float>(line) * line_height;
+
+        auto match_number = static_cast<size_t>(std::distance(matches.begin(), iter));
+        ImU32 color = match_number == active_match ? ACTIVE_MATCH_COLOR : MATCH_HIGHLIGHT_COLOR;
+        draw_list->AddRectFilled(ImVec2(text_origin.x + x_begin, y_top),
+                                 ImVec2(text_origin.x + x_end, y_top + line_height), color);
+    }
+    draw_list->PopClipRect();
+}
 
-    for (size_t i = 0; i < minified.size(); i++) {
-        char chr = minified[i];
+// Draws every line of `formatted` that intersects the clip rect, with the first glyph at `origin`.
+// Used instead of a text widget for large documents, which it would scan in full every frame.
+void draw_visible_lines(const FormattedJson& formatted, ImVec2 origin) {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    float line_height = ImGui::GetTextLineHeight();
+    float first_visible = std::max(0.0F, (draw_list->GetClipRectMin().y - origin.y) / line_height);
+    float last_visible = (draw_list->GetClipRectMax().y - origin.y) / line_height;
+    if (last_visible < 0.0F) {
+        return;
+    }
+    auto first_line = std::min(static_cast<size_t>(first_visible), formatted.line_count());
+    auto last_line = std::min(static_cast<size_t>(last_visible) + 1, formatted.line_count());
+
+    const char* text = formatted.text.c_str();
+    ImU32 color = ImGui::GetColorU32(ImGuiCol_Text);
+    for (size_t line = first_line; line < last_line; line++) {
+        size_t line_end = line + 1 < formatted.line_count() ? formatted.line_starts[line + 1] - 1
+                                                            : formatted.text.size();
+        draw_list->AddText(ImVec2(origin.x, origin.y + static_cast<float>(line) * line_height),
+                           color, text + formatted.line_starts[line], text + line_end);
+    }
+}
 
-        if (chr == '"' && (i == 0 || minified[i - 1] != '\\')) {
-            in_string = !in_string;
-            formatted << chr;
-            continue;
+// Draws a formatted document with its match highlights and next/previous navigation.
+// Returns the screen y of the match to scroll to when the user jumped to one.
+std::optional<float> draw_document(const FormattedJson& formatted, const MatchRanges& matches,
+                                   size_t& current_match) {
+    bool scroll_to_match = false;
+    if (current_match >= matches.size()) {
+        current_match = 0;
+    }
+    if (!matches.empty()) {
+        if (ImGui::SmallButton("< Prev")) {
+            current_match = (current_match + matches.size() - 1) % matches.size();
+            scroll_to_match = true;
         }
-
-        if (in_string) {
-            formatted << chr;
-            continue;
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Next >")) {
+            current_match = (current_match + 1) % matches.size();
+            scroll_to_match = true;
         }
+        ImGui::SameLine();
+        ImGui::Text("Match %zu of %zu", current_match + 1, matches.size());
+    }
 
-        switch (chr) {
-        case '{':
-        case '[':
-            formatted << chr << '\n';
-            indent += INDENT_SIZE;
-            formatted << std::string(static_cast<size_t>(indent), ' ');
-            break;
-        case '}':
-        case ']':
-            formatted << '\n';
-            indent -= INDENT_SIZE;
-            if (indent < 0) {
-                indent = 0;
-            }
-            formatted << std::string(static_cast<size_t>(indent), ' ') << chr;
-            break;
-        case ',':
-            formatted << chr << '\n' << std::string(static_cast<size_t>(indent), ' ');
-            break;
-        case ':':
-            formatted << chr << ' ';
-            break;
-        default:
-            formatted << chr;
-            break;
-        }
+    // Calculate height based on line count
+    float line_height = ImGui::GetTextLineHeight();
+    float text_height = static_cast<float>(formatted.line_count()) * line_height + line_height;
+    const ImGuiStyle& style = ImGui::GetStyle();
+    ImVec2 frame_min = ImGui::GetCursorScreenPos();
+    ImVec2 frame_max(frame_min.x + ImGui::GetContentRegionAvail().x, frame_min.y + text_height);
+    ImVec2 text_origin(frame_min.x + style.FramePadding.x, frame_min.y + style.FramePadding.y);
+
+    // The text widget is a child window drawn after this one, so its background is painted here
+    // (and made transparent on the widget) for the highlights to sit between the two
+    bool selectable = formatted.text.size() <= SELECTABLE_TEXT_LIMIT;
+    if (selectable) {
+        ImGui::GetWindowDrawList()->AddRectFilled(frame_min, frame_max,
+                                                  ImGui::GetColorU32(ImGuiCol_FrameBg),
+                                                  style.FrameRounding);
+    }
+    if (!matches.empty()) {
+        draw_match_highlights(formatted, matches, current_match, text_origin, frame_min,
+                              frame_max);
+    }
+
+    if (selectable) {
+        // Selectable read-only text input (ReadOnly: the buffer is never written)
+        ImGui::PushStyleColor(ImGuiCol_FrameBg, IM_COL32(0, 0, 0, 0));
+        ImGui::InputTextMultiline("##json", const_cast<char*>(formatted.text.data()),
+                                  formatted.text.size() + 1, ImVec2(-FLT_MIN, text_height),
+                                  ImGuiInputTextFlags_ReadOnly);
+        ImGui::PopStyleColor();
+    } else {
+        ImGui::Dummy(ImVec2(ImGui::GetContentRegionAvail().x, text_height));
+        draw_visible_lines(formatted, text_origin);
     }
 
-    return formatted.str();
+    if (!scroll_to_match) {
+        return std::nullopt;
+    }
+    size_t line = formatted.line_of(matches[current_match].first);
+    return text_origin.y + static_cast<float>(line) * line_height;
+}
+
+// ImGui ID scope for a document row. Hashes all 8 bytes of the index, where
+// PushID(int) would truncate indices past 2^31.
+void push_document_id(uint64_t doc_index) {
+    const char* bytes = reinterpret_cast<const char*>(&doc_index);
+    ImGui::PushID(bytes, bytes + sizeof(doc_index));
+}
+
+// Open state of a row's tree node, as stored by ImGui (call inside the document list)
+bool is_document_expanded(size_t doc_index) {
+    push_document_id(doc_index);
+    ImGuiID node_id = ImGui::GetID("");
+    ImGui::PopID();
+    return ImGui::GetStateStorage()->GetInt(node_id, 0) != 0;
 }
 
 void file_dialog_callback(void* userdata, const char* const* filelist, int /*filter*/) {
@@ -94,10 +252,8 @@ void file_dialog_callback(void* userdata, const char* const* filelist, int /*fil
         std::strncpy(path_buffer->data(), filelist[0], SEARCH_BUFFER_SIZE - 1);
         path_buffer->at(SEARCH_BUFFER_SIZE - 1) = '\0';
 
-        // Start parsing in background thread
-        std::string path = path_buffer->data();
-        std::thread parser_thread([path]() { json_parser(path); });
-        parser_thread.detach();
+        // Start parsing on the worker pool
+        start_json_load(path_buffer->data());
     }
 }
 
@@ -112,49 +268,98 @@ void draw_json_viewer_panel() {
 
     static std::array<char, SEARCH_BUFFER_SIZE> search_buffer = {};
     static std::array<char, SEARCH_BUFFER_SIZE> file_path_buffer = {};
-    static std::vector<size_t> filtered_indices;
+    static ResultSet filtered_indices;
     static std::string active_search;
     static size_t last_generation = 0;
 
-    // Search state for incremental searching
+    // Search state for incremental searching (advanced by the frame scheduler)
+    static FrameScheduler::JobId search_job = 0;
+    static std::unique_ptr<ParallelSearch> parallel_search;
     static bool search_in_progress = false;
     static size_t search_current_index = 0;
-    static std::string search_query;
-
-    size_t total_count = data.document_count();
+    static SearchQuery search_query;
+    static SearchResults search_results;
+    static int combine_mode = 0;
+    static bool negate_search = false;
+    static CombineMode search_combine = CombineMode::Replace;
+    static bool search_negated = false;
+
+    // Match highlighting for the most recent positive search
+    static SearchQuery highlight_query;
+    static MatchOffsets highlight_offsets;
+    static std::unordered_map<size_t, size_t> active_match; // Document -> selected match
+
+    // Measured row heights of the document list
+    static HeightIndex row_heights;
+    static uint64_t list_version = 0; // Bumped whenever filtered_indices changes
+    static uint64_t measured_list = UINT64_MAX;
+    static ScrollAnchor list_scroll;
+
+    // The state above is UI-thread only, as is the memory panel that reports it
+    [[maybe_unused]] static const bool memory_reporters_registered = [] {
+        register_memory_reporter("viewer_search", [] {
+            return search_results.memory_bytes() + filtered_indices.memory_bytes() +
+                   highlight_offsets.memory_bytes();
+        });
+        register_memory_reporter("row_heights", [] { return row_heights.memory_bytes(); });
+        return true;
+    }();
+
+    // Drop formatted documents (and cancel formatting) for nodes no longer open
+    get_document_formatter().begin_frame();
+
+    // One snapshot per frame: documents are viewed in place and stay valid
+    // even if a new file is published mid-frame
+    DatasetSnapshot snapshot = data.snapshot();
+    size_t total_count = snapshot.document_count();
 
     // Reset state when a new file is loaded
-    size_t current_generation = data.generation();
+    size_t current_generation = snapshot.generation();
     if (current_generation != last_generation) {
         last_generation = current_generation;
+        get_frame_scheduler().cancel(search_job);
+        parallel_search.reset();
         search_buffer.fill('\0');
         active_search.clear();
         filtered_indices.clear();
         search_in_progress = false;
         search_current_index = 0;
-        search_query.clear();
+        search_query = {};
+        search_results.clear();
+        highlight_query = {};
+        highlight_offsets.clear();
+        active_match.clear();
+        get_query_cache().clear();
+        get_document_formatter().clear();
         // Initialize with all documents
-        for (size_t i = 0; i < total_count; i++) {
-            filtered_indices.push_back(i);
-        }
+        filtered_indices = ResultSet::all(total_count);
+        list_version++;
     }
 
-    // Incremental search processing
-    if (search_in_progress) {
-        size_t end_index = std::min(search_current_index + SEARCH_BATCH_SIZE, total_count);
-
-        for (size_t i = search_current_index; i < end_index; i++) {
-            std::string doc = data.get_document(i);
-            if (doc.find(search_query) != std::string::npos) {
-                filtered_indices.push_back(i);
-            }
-        }
-
-        search_current_index = end_index;
-
-        if (search_current_index >= total_count) {
-            search_in_progress = false;
+    // Merge a completed scan (or cache hit) into the displayed results
+    auto finish_search = [&]() {
+        search_in_progress = false;
+        active_match.clear();
+        if (search_negated) {
+            filtered_indices = combine_results(
+                filtered_indices, search_results.matches.complement(total_count), search_combine);
+            highlight_query = {};
+            highlight_offsets.clear();
+        } else {
+            filtered_indices =
+                combine_results(filtered_indices, search_results.matches, search_combine);
+            highlight_query = search_query;
+            highlight_offsets = std::move(search_results.offsets);
         }
+        search_results.clear();
+        list_version++;
+    };
+
+    // Collect a scan the frame scheduler has completed
+    if (search_in_progress && search_current_index >= total_count) {
+        parallel_search.reset();
+        get_query_cache().insert(search_query, current_generation, search_results);
+        finish_search();
     }
 
     // Make window fullscreen
@@ -189,41 +394,107 @@ void draw_json_viewer_panel() {
     ImGui::SameLine();
     // Disable Search button while search is in progress
     bool was_searching = search_in_progress;
+    bool scripted_search = viewer_script.search.has_value() && !was_searching;
+    if (scripted_search) {
+        std::strncpy(search_buffer.data(), viewer_script.search->c_str(), search_buffer.size() - 1);
+        viewer_script.search.reset();
+    }
     if (was_searching) {
         ImGui::BeginDisabled();
     }
-    if (ImGui::Button("Search")) {
+    if (ImGui::Button("Search") || scripted_search) {
         std::string search_str = search_buffer.data();
-        active_search = search_str;
-        filtered_indices.clear();
+        auto mode = static_cast<CombineMode>(combine_mode);
 
         if (search_str.empty()) {
             // No filter - show all
-            for (size_t i = 0; i < total_count; i++) {
-                filtered_indices.push_back(i);
-            }
+            active_search.clear();
+            filtered_indices = ResultSet::all(total_count);
+            list_version++;
         } else {
             // Start incremental search
-            search_query = search_str;
-            search_current_index = 0;
-            search_in_progress = true;
+            if (mode == CombineMode::Replace || active_search.empty()) {
+                mode = CombineMode::Replace;
+                active_search = describe_search(search_str, negate_search);
+            } else {
+                active_search = "(" + active_search + ") " +
+                                COMBINE_MODE_LABELS.at(static_cast<size_t>(mode)) + " " +
+                                describe_search(search_str, negate_search);
+            }
+            search_query = {SearchKind::Substring, search_str};
+            search_combine = mode;
+            search_negated = negate_search;
+
+            // Recent queries are answered from the cache without rescanning
+            std::optional<SearchResults> cached =
+                get_query_cache().find(search_query, current_generation);
+            if (cached) {
+                search_results = std::move(*cached);
+                search_current_index = total_count;
+                finish_search();
+            } else {
+                search_results.clear();
+                search_current_index = 0;
+                search_in_progress = true;
+
+                // Workers scan chunks; the scheduler merges finished ones within the frame budget
+                parallel_search = std::make_unique<ParallelSearch>(search_query, snapshot);
+                search_job = get_frame_scheduler().add("search", [](size_t max_units) {
+                    size_t merged = parallel_search->collect(search_results, max_units);
+                    search_current_index = parallel_search->documents_scanned();
+                    return JobStep{merged, parallel_search->is_complete()};
+                });
+            }
         }
     }
+
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(COMBINE_COMBO_WIDTH);
+    ImGui::Combo("##combine", &combine_mode, COMBINE_MODE_LABELS.data(),
+                 static_cast<int>(COMBINE_MODE_LABELS.size()));
+    ImGui::SameLine();
+    ImGui::Checkbox("NOT", &negate_search);
     if (was_searching) {
         ImGui::EndDisabled();
     }
 
     ImGui::SameLine();
     if (ImGui::Button("Clear")) {
+        get_frame_scheduler().cancel(search_job);
+        parallel_search.reset();
         search_buffer.fill('\0');
         active_search.clear();
-        filtered_indices.clear();
         search_in_progress = false;
         search_current_index = 0;
-        search_query.clear();
-        for (size_t i = 0; i < total_count; i++) {
-            filtered_indices.push_back(i);
+        search_query = {};
+        search_results.clear();
+        highlight_query = {};
+        highlight_offsets.clear();
+        active_match.clear();
+        filtered_indices = ResultSet::all(total_count);
+        list_version++;
+    }
+
+    // A new file loads in the background while the current one stays browsable
+    LoadingState& loading = get_loading_state();
+    if (loading.is_loading) {
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel Load")) {
+            cancel_json_load();
         }
+        ImGui::SameLine();
+        ImGui::Text("%s", loading.status_message.c_str());
+        LoadProgress progress = loading.progress();
+        if (progress.eta_seconds >= 0.0) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(%.0f MB/s, ETA %.0f s)",
+                                progress.bytes_per_second / (1024.0 * 1024.0),
+                                progress.eta_seconds);
+        }
+    } else if (!loading.error_message.empty()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0F, 0.3F, 0.3F, 1.0F), "Load failed: %s",
+                           loading.error_message.c_str());
     }
 
     ImGui::PopStyleVar();
@@ -233,16 +504,22 @@ void draw_json_viewer_panel() {
         float progress = static_cast<float>(search_current_index) / static_cast<float>(total_count);
         ImGui::ProgressBar(progress, ImVec2(-1.0F, 0.0F), "Searching...");
         ImGui::Text("Searched %zu / %zu documents, found %zu matches", search_current_index,
-                    total_count, filtered_indices.size());
+                    total_count, static_cast<size_t>(search_results.matches.size()));
     }
 
+    // A plain new search shows its matches as they arrive; combined or negated
+    // searches keep the previous results until the scan completes
+    bool show_partial =
+        search_in_progress && search_combine == CombineMode::Replace && !search_negated;
+    const ResultSet& display_set = show_partial ? search_results.matches : filtered_indices;
+
     // Document count (only show when not searching)
-    size_t display_count = filtered_indices.size();
+    size_t display_count = display_set.size();
     if (!search_in_progress) {
         if (active_search.empty()) {
             ImGui::Text("Total documents: %zu", total_count);
         } else {
-            ImGui::Text("Showing %zu of %zu documents (search: \"%s\")", display_count, total_count,
+            ImGui::Text("Showing %zu of %zu documents (search: %s)", display_count, total_count,
                         active_search.c_str());
         }
     }
@@ -250,46 +527,151 @@ void draw_json_viewer_panel() {
     ImGui::Separator();
 
     // === DOCUMENT LIST ===
-    ImGui::BeginChild("DocumentList", ImVec2(0, 0), ImGuiChildFlags_None,
+    // The list keeps its own 64-bit scroll position (list_scroll) and draws its
+    // own scrollbar; ImGui only scrolls it horizontally
+    float scrollbar_width = ImGui::GetStyle().ScrollbarSize;
+    ImVec2 list_min = ImGui::GetCursorScreenPos();
+    ImVec2 list_size = ImGui::GetContentRegionAvail();
+    list_size.x = std::max(list_size.x - scrollbar_width, 1.0F);
+    list_size.y = std::max(list_size.y, 1.0F);
+    ImGui::SetNextWindowContentSize(ImVec2(0.0F, 1.0F));
+    ImGui::SetNextWindowScroll(ImVec2(-1.0F, 0.0F));
+    ImGui::BeginChild("DocumentList", list_size, ImGuiChildFlags_None,
                       ImGuiWindowFlags_HorizontalScrollbar);
 
-    // Virtual scrolling - only renders visible items
-    ImGuiListClipper clipper;
-    clipper.Begin(static_cast<int>(display_count));
+    // Match lists only live for this frame
+    std::pmr::memory_resource* frame_memory = &PanelManager::instance().frame_arena();
+    DocumentFormatter& formatter = get_document_formatter();
+    static const SearchQuery no_scan;
+
+    // Row heights are re-measured from scratch whenever the list's contents change;
+    // partial search results only grow, so they keep what was measured
+    float default_row_height = ImGui::GetTextLineHeightWithSpacing();
+    uint64_t list_key = list_version * 2 + (show_partial ? 1 : 0);
+    if (list_key != measured_list || row_heights.default_height() != default_row_height) {
+        row_heights.reset(display_count, default_row_height);
+        measured_list = list_key;
+    } else {
+        row_heights.resize(display_count);
+    }
+
+    // Mouse wheel moves the anchor directly, so the position stays exact at any depth
+    const ImGuiIO& imgui_io = ImGui::GetIO();
+    float view_height = ImGui::GetWindowHeight();
+    if (ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows) && imgui_io.MouseWheel != 0.0F &&
+        !imgui_io.KeyShift) {
+        list_scroll.scroll_by(row_heights, -static_cast<double>(imgui_io.MouseWheel) *
+                                               WHEEL_SCROLL_ROWS * default_row_height);
+    }
+    if (viewer_script.jump_fraction) {
+        double target = *viewer_script.jump_fraction * row_heights.total_height();
+        list_scroll.scroll_to(row_heights, target);
+        viewer_script.jump_fraction.reset();
+    }
+    list_scroll.clamp(row_heights, view_height);
+
+    // Virtual scrolling: lay out only the rows intersecting the viewport, starting
+    // at the anchor row (positions stay small floats however deep the list goes)
+    // and measuring each row as it is drawn
+    float list_top = ImGui::GetCursorPosY();
+    uint64_t visible_begin = list_scroll.row();
+    uint64_t visible_end = visible_begin;
+    ImGui::SetCursorPosY(list_top - static_cast<float>(list_scroll.offset()));
+    std::optional<double> scroll_request;
+
+    if (display_count > 0) {
+        // Walk the compressed set directly from the first visible rank
+        auto doc_iter = display_set.iterator_at(visible_begin);
+        for (; visible_end < display_count; visible_end++, ++doc_iter) {
+            float row_top = ImGui::GetCursorPosY();
+            if (row_top - list_top >= view_height) {
+                break;
+            }
+            uint64_t doc_index = *doc_iter;
+            push_document_id(doc_index);
 
-    while (clipper.Step()) {
-        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-            size_t doc_index = filtered_indices[static_cast<size_t>(i)];
-            ImGui::PushID(static_cast<int>(doc_index));
+            if (viewer_script.toggle_rows > 0) {
+                ImGui::SetNextItemOpen(viewer_script.toggle_open);
+                viewer_script.toggle_rows--;
+            }
 
             // Collapsible tree node for each document
-            if (ImGui::TreeNode("", "Document %zu", doc_index)) {
-                std::string raw_doc = data.get_document(doc_index);
-                std::string formatted = format_json(raw_doc);
-
-                // Calculate height based on line count
-                size_t line_count = 1;
-                for (char chr : formatted) {
-                    if (chr == '\n') {
-                        line_count++;
+            if (ImGui::TreeNode("", "Document %llu", static_cast<unsigned long long>(doc_index))) {
+                // Formatting (and scanning documents the search did not record) runs on a worker
+                bool needs_scan =
+                    !highlight_query.text.empty() && !highlight_offsets.is_recorded(doc_index);
+                std::shared_ptr<const MaterializedDocument> document = formatter.request(
+                    snapshot, doc_index, needs_scan ? highlight_query : no_scan);
+
+                if (document) {
+                    std::span<const uint64_t> raw_offsets = needs_scan
+                                                                ? document->scanned_offsets
+                                                                : highlight_offsets.find(doc_index);
+                    MatchRanges matches =
+                        map_matches(*document->formatted, raw_offsets,
+                                    match_length(highlight_query), frame_memory);
+                    std::optional<float> match_y =
+                        draw_document(*document->formatted, matches, active_match[doc_index]);
+                    if (match_y) {
+                        float target_y = ImGui::GetWindowPos().y + MATCH_SCROLL_RATIO * view_height;
+                        scroll_request = static_cast<double>(*match_y - target_y);
                     }
+                } else {
+                    ImGui::ProgressBar(formatter.progress(doc_index), ImVec2(-FLT_MIN, 0.0F),
+                                       "Formatting...");
                 }
-                float line_height = ImGui::GetTextLineHeight();
-                float text_height = static_cast<float>(line_count) * line_height + line_height;
-
-                // Selectable read-only text input
-                ImGui::InputTextMultiline("##json", formatted.data(), formatted.size() + 1,
-                                          ImVec2(-FLT_MIN, text_height),
-                                          ImGuiInputTextFlags_ReadOnly);
                 ImGui::TreePop();
             }
 
             ImGui::PopID();
+            row_heights.set_height(visible_end, ImGui::GetCursorPosY() - row_top);
         }
     }
 
+    viewer_script.toggle_rows = 0;
+
+    // Jumps to a match apply from the next frame, once this frame's heights are measured
+    if (scroll_request) {
+        list_scroll.scroll_by(row_heights, *scroll_request);
+    }
+
+    // Warm the rows the list is scrolling towards
+    get_prefetcher().update(snapshot, display_set, list_key, visible_begin, visible_end,
+                            is_document_expanded);
+
     ImGui::EndChild();
+
+    // Scrollbar over the whole list, in 64-bit pixels
+    ImRect scrollbar_rect(ImVec2(list_min.x + list_size.x, list_min.y),
+                          ImVec2(list_min.x + list_size.x + scrollbar_width,
+                                 list_min.y + list_size.y));
+    auto scroll_position = static_cast<ImS64>(list_scroll.position(row_heights));
+    ImS64 dragged_position = scroll_position;
+    ImGui::ScrollbarEx(scrollbar_rect, ImGui::GetID("##list_scrollbar"), ImGuiAxis_Y,
+                       &dragged_position, static_cast<ImS64>(view_height),
+                       static_cast<ImS64>(row_heights.total_height()));
+    if (dragged_position != scroll_position) {
+        list_scroll.scroll_to(row_heights, static_cast<double>(dragged_position));
+    }
     ImGui::End();
+    viewer_script.search_running = search_in_progress;
+}
+
+void script_viewer_search(const std::string& text) {
+    viewer_script.search = text;
+}
+
+void script_viewer_set_open(size_t rows, bool open) {
+    viewer_script.toggle_rows = rows;
+    viewer_script.toggle_open = open;
+}
+
+void script_viewer_jump(double fraction) {
+    viewer_script.jump_fraction = std::clamp(fraction, 0.0, 1.0);
+}
+
+bool viewer_search_in_progress() {
+    return viewer_script.search_running || viewer_script.search.has_value();
 }
 
 REGISTER_PANEL(draw_json_viewer_panel);
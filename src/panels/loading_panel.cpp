@@ -2,14 +2,52 @@
 
 #include "panel_manager.hpp"
 #include "utils/json_data_store.hpp"
+#include "utils/json_parser.hpp"
 #include "utils/loading_state.hpp"
 
+#include <cstdio>
 #include <imgui/imgui.h>
 
 namespace {
 constexpr float WINDOW_WIDTH = 500.0F;
-constexpr float WINDOW_HEIGHT = 150.0F;
+constexpr float WINDOW_HEIGHT = 260.0F;
 constexpr float CENTER_PIVOT = 0.5F;
+constexpr float CANCEL_BUTTON_WIDTH = 80.0F;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+// Progress bar, throughput and ETA of the running load phase
+void draw_phase_progress(const LoadProgress& progress) {
+    double done_mb = static_cast<double>(progress.bytes_done) / BYTES_PER_MB;
+    if (progress.bytes_total > 0) {
+        double total_mb = static_cast<double>(progress.bytes_total) / BYTES_PER_MB;
+        char overlay[64];
+        std::snprintf(overlay, sizeof(overlay), "%.0f / %.0f MB", done_mb, total_mb);
+        float fraction = static_cast<float>(done_mb / total_mb);
+        ImGui::ProgressBar(fraction, ImVec2(-1.0F, 0.0F), overlay);
+    }
+
+    double rate_mb = progress.bytes_per_second / BYTES_PER_MB;
+    const char* phase = load_phase_name(progress.phase);
+    if (progress.eta_seconds >= 0.0) {
+        ImGui::Text("%s: %.1f MB/s, ETA %.1f s", phase, rate_mb, progress.eta_seconds);
+    } else {
+        ImGui::Text("%s: %.1f MB/s", phase, rate_mb);
+    }
+}
+
+// Time and throughput of the phases this load has finished
+void draw_finished_phases(const LoadingState& state, LoadPhase running) {
+    for (size_t slot = 0; slot < LOAD_PHASE_COUNT; slot++) {
+        auto phase = static_cast<LoadPhase>(slot);
+        double seconds = state.phases[slot].seconds.load();
+        if (phase == running || seconds <= 0.0) {
+            continue;
+        }
+        double megabytes = static_cast<double>(state.phases[slot].bytes.load()) / BYTES_PER_MB;
+        ImGui::TextDisabled("%s: %.0f MB in %.2f s (%.1f MB/s)", load_phase_name(phase),
+                            megabytes, seconds, megabytes / seconds);
+    }
+}
 } // namespace
 
 void draw_loading_panel() {
@@ -46,6 +84,12 @@ void draw_loading_panel() {
     // Status message
     ImGui::Text("%s", state.status_message.c_str());
 
+    LoadProgress progress = state.progress();
+    draw_finished_phases(state, progress.phase);
+    if (progress.phase != LoadPhase::Count) {
+        draw_phase_progress(progress);
+    }
+
     // Documents loaded
     if (state.documents_loaded > 0) {
         ImGui::Text("Documents loaded: %zu", state.documents_loaded.load());
@@ -58,6 +102,10 @@ void draw_loading_panel() {
     }
 
     ImGui::Text("Please wait...");
+    ImGui::SameLine();
+    if (ImGui::Button("Cancel", ImVec2(CANCEL_BUTTON_WIDTH, 0.0F))) {
+        cancel_json_load();
+    }
 
     ImGui::End();
 }
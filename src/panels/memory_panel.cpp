@@ -0,0 +1,90 @@
+#include "panels/memory_panel.hpp"
+
+#include "panel_manager.hpp"
+#include "utils/memory_stats.hpp"
+
+#include <algorithm>
+#include <imgui/imgui.h>
+
+namespace {
+constexpr ImGuiKey TOGGLE_KEY = ImGuiKey_F5;
+constexpr float WINDOW_MARGIN = 10.0F;
+constexpr float WINDOW_WIDTH = 300.0F;
+constexpr float BACKGROUND_ALPHA = 0.85F;
+constexpr double REFRESH_SECONDS = 0.5; // Reporters and /proc are read at most this often
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+double to_mb(size_t bytes) {
+    return static_cast<double>(bytes) / BYTES_PER_MB;
+}
+
+void byte_row(const char* name, double megabytes) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(name);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.1f", megabytes);
+}
+} // namespace
+
+void draw_memory_panel() {
+    static bool visible = false;
+    static MemoryReport report;
+    static double last_refresh = -REFRESH_SECONDS;
+
+    if (ImGui::IsKeyPressed(TOGGLE_KEY, false)) {
+        visible = !visible;
+        last_refresh = -REFRESH_SECONDS;
+    }
+    if (!visible) {
+        return;
+    }
+
+    double now = ImGui::GetTime();
+    if (now - last_refresh >= REFRESH_SECONDS) {
+        last_refresh = now;
+        report = memory_report();
+        std::sort(report.items.begin(), report.items.end(),
+                  [](const MemoryUsage& a, const MemoryUsage& b) { return a.bytes > b.bytes; });
+    }
+
+    ImGuiIO& imgui_io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(imgui_io.DisplaySize.x - WINDOW_MARGIN,
+                                   imgui_io.DisplaySize.y - WINDOW_MARGIN),
+                            ImGuiCond_Always, ImVec2(1.0F, 1.0F));
+    ImGui::SetNextWindowSize(ImVec2(WINDOW_WIDTH, 0.0F), ImGuiCond_Always);
+    ImGui::SetNextWindowBgAlpha(BACKGROUND_ALPHA);
+
+    constexpr ImGuiWindowFlags window_flags =
+        ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove |
+        ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+        ImGuiWindowFlags_NoNav | ImGuiWindowFlags_AlwaysAutoResize;
+
+    ImGui::Begin("Memory", nullptr, window_flags);
+    ImGui::Text("Memory (MB)  F5: hide");
+
+    constexpr ImGuiTableFlags table_flags =
+        ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("##memory", 2, table_flags)) {
+        ImGui::TableSetupColumn("structure", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("MB");
+        ImGui::TableHeadersRow();
+        for (const MemoryUsage& item : report.items) {
+            byte_row(item.name, to_mb(item.bytes));
+        }
+        byte_row("accounted", to_mb(report.accounted_bytes));
+        if (report.rss_bytes > 0) {
+            byte_row("process RSS", to_mb(report.rss_bytes));
+            // Heap overhead, code, ImGui, allocator slack and anything not reported
+            byte_row("unaccounted", to_mb(report.rss_bytes) - to_mb(report.accounted_bytes));
+        }
+        if (report.peak_rss_bytes > 0) {
+            byte_row("peak RSS", to_mb(report.peak_rss_bytes));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+REGISTER_PANEL(draw_memory_panel);
@@ -0,0 +1,148 @@
+#include "panels/profiler_panel.hpp"
+
+#include "frame_profiler.hpp"
+#include "panel_manager.hpp"
+#include "utils/trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <imgui/imgui.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr ImGuiKey TOGGLE_KEY = ImGuiKey_F3;
+constexpr ImGuiKey TRACE_KEY = ImGuiKey_F4;
+constexpr float WINDOW_MARGIN = 10.0F;
+constexpr float WINDOW_WIDTH = 360.0F;
+constexpr float BACKGROUND_ALPHA = 0.85F;
+constexpr float GRAPH_HEIGHT = 60.0F;
+constexpr float GRAPH_MIN_SCALE_MS = 33.3F; // Two 60 Hz frames
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+// last/avg/max over the stored frames of one value
+struct Stat {
+    float last = 0.0F;
+    float average = 0.0F;
+    float max = 0.0F;
+};
+
+template <typename Value> Stat compute_stat(const FrameProfiler& profiler, Value value) {
+    Stat stat;
+    size_t count = profiler.frame_count();
+    float sum = 0.0F;
+    for (size_t age = 0; age < count; age++) {
+        float ms = value(profiler.frame(age));
+        sum += ms;
+        stat.max = std::max(stat.max, ms);
+    }
+    stat.last = value(profiler.frame(0));
+    stat.average = sum / static_cast<float>(count);
+    return stat;
+}
+
+void stat_row(const char* name, const Stat& stat) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(name);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", stat.last);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", stat.average);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", stat.max);
+}
+
+// Oldest frame on the left
+float total_ms_at(void* data, int index) {
+    const auto* profiler = static_cast<const FrameProfiler*>(data);
+    return profiler->frame(profiler->frame_count() - 1 - static_cast<size_t>(index)).total_ms;
+}
+} // namespace
+
+void draw_profiler_panel() {
+    FrameProfiler& profiler = get_frame_profiler();
+    if (ImGui::IsKeyPressed(TOGGLE_KEY, false)) {
+        profiler.set_enabled(!profiler.enabled());
+    }
+    // First press starts trace recording, later presses write what has been recorded
+    if (ImGui::IsKeyPressed(TRACE_KEY, false)) {
+        if (!trace_enabled()) {
+            set_trace_enabled(true);
+            std::fprintf(stderr, "trace: recording (F4 again to write)\n");
+        } else {
+            std::string path = trace_output_path();
+            bool written = write_trace(path);
+            std::fprintf(stderr, "trace: %s %s\n", written ? "wrote" : "cannot write",
+                         path.c_str());
+        }
+    }
+    if (!profiler.enabled() || profiler.frame_count() == 0) {
+        return;
+    }
+
+    ImGuiIO& imgui_io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(imgui_io.DisplaySize.x - WINDOW_MARGIN, WINDOW_MARGIN),
+                            ImGuiCond_Always, ImVec2(1.0F, 0.0F));
+    ImGui::SetNextWindowSize(ImVec2(WINDOW_WIDTH, 0.0F), ImGuiCond_Always);
+    ImGui::SetNextWindowBgAlpha(BACKGROUND_ALPHA);
+
+    constexpr ImGuiWindowFlags window_flags =
+        ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove |
+        ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+        ImGuiWindowFlags_NoNav | ImGuiWindowFlags_AlwaysAutoResize;
+
+    ImGui::Begin("Profiler", nullptr, window_flags);
+
+    Stat frame = compute_stat(profiler, [](const FrameProfiler::Frame& f) { return f.total_ms; });
+    ImGui::Text("Frame %.2f ms (avg %.2f, max %.2f)  F3: hide", frame.last, frame.average,
+                frame.max);
+    ImGui::PlotLines("##frame_times", total_ms_at, &profiler,
+                     static_cast<int>(profiler.frame_count()), 0, nullptr, 0.0F,
+                     std::max(GRAPH_MIN_SCALE_MS, frame.max), ImVec2(-1.0F, GRAPH_HEIGHT));
+
+    constexpr ImGuiTableFlags table_flags =
+        ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("##phases", 4, table_flags)) {
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("last");
+        ImGui::TableSetupColumn("avg");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+
+        const std::vector<PanelManager::PanelTiming>& panels =
+            PanelManager::instance().last_frame_timings();
+        for (size_t phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+            stat_row(frame_phase_name(static_cast<FramePhase>(phase)),
+                     compute_stat(profiler, [phase](const FrameProfiler::Frame& f) {
+                         return f.phase_ms[phase];
+                     }));
+            if (static_cast<FramePhase>(phase) != FramePhase::Panels) {
+                continue;
+            }
+            ImGui::Indent();
+            for (size_t panel = 0; panel < std::min(panels.size(), FrameProfiler::MAX_PANELS);
+                 panel++) {
+                stat_row(panels[panel].name,
+                         compute_stat(profiler, [panel](const FrameProfiler::Frame& f) {
+                             return f.panel_ms[panel];
+                         }));
+            }
+            ImGui::Unindent();
+        }
+        ImGui::EndTable();
+    }
+
+    PanelManager& manager = PanelManager::instance();
+    ImGui::Text("Heap allocations last frame: %llu",
+                static_cast<unsigned long long>(manager.last_frame_allocations()));
+    const FrameArena& arena = manager.frame_arena();
+    ImGui::Text("Frame arena: %.1f / %.1f MB (peak %.1f)",
+                static_cast<double>(arena.bytes_used()) / BYTES_PER_MB,
+                static_cast<double>(arena.capacity()) / BYTES_PER_MB,
+                static_cast<double>(arena.peak_bytes()) / BYTES_PER_MB);
+
+    ImGui::End();
+}
+
+REGISTER_PANEL(draw_profiler_panel);
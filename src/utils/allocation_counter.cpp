@@ -0,0 +1,111 @@
+#include "utils/allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+// Trivially constructible, so it is safe to touch from inside operator new
+thread_local uint64_t heap_allocations = 0;
+
+void* counted_allocate(std::size_t size) {
+    heap_allocations++;
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* ptr = std::malloc(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* counted_allocate_aligned(std::size_t size, std::align_val_t alignment) {
+    heap_allocations++;
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires a size that is a multiple of the alignment
+    size = size == 0 ? align : (size + align - 1) / align * align;
+    while (true) {
+#ifdef _WIN32
+        void* ptr = _aligned_malloc(size, align);
+#else
+        void* ptr = std::aligned_alloc(align, size);
+#endif
+        if (ptr != nullptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+void free_aligned(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+} // namespace
+
+uint64_t thread_heap_allocations() {
+    return heap_allocations;
+}
+
+void* operator new(std::size_t size) {
+    return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept {
+    free_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*alignment*/) noexcept {
+    free_aligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+    free_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+    free_aligned(ptr);
+}
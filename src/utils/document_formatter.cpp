@@ -0,0 +1,185 @@
+#include "utils/document_formatter.hpp"
+
+#include "utils/memory_stats.hpp"
+#include "utils/ui_wake.hpp"
+
+#include <string_view>
+#include <utility>
+
+namespace {
+bool covers(const MaterializedDocument& document, const SearchQuery& scan_query) {
+    return scan_query.text.empty() || document.scanned_query == scan_query;
+}
+} // namespace
+
+REGISTER_MEMORY_REPORTER(formatted_cache,
+                         [] { return get_document_formatter().cache_stats().bytes; });
+
+DocumentFormatter& DocumentFormatter::instance() {
+    static DocumentFormatter formatter;
+    return formatter;
+}
+
+DocumentFormatter& get_document_formatter() {
+    return DocumentFormatter::instance();
+}
+
+void DocumentFormatter::begin_frame() {
+    // Finished jobs nobody collected (prefetches, mostly) go into the cache
+    std::erase_if(pending_, [this](const auto& entry) {
+        PendingJob& job = *entry.second;
+        if (job.requested || !job.done.load(std::memory_order_acquire)) {
+            return false;
+        }
+        if (job.result) {
+            cache_.insert(entry.first, job.result, job.result->memory_bytes());
+        }
+        return true;
+    });
+
+    std::erase_if(in_use_, [](const auto& entry) { return !entry.second.requested; });
+    for (auto& [index, entry] : in_use_) {
+        entry.requested = false;
+    }
+
+    std::erase_if(pending_, [](const auto& entry) {
+        if (!entry.second->requested && !entry.second->prefetch) {
+            entry.second->handle.cancel();
+            return true;
+        }
+        return false;
+    });
+    for (auto& [index, job] : pending_) {
+        job->requested = false;
+    }
+}
+
+std::shared_ptr<const MaterializedDocument>
+DocumentFormatter::request(const DatasetSnapshot& snapshot, size_t index,
+                           const SearchQuery& scan_query) {
+    sync_generation(snapshot);
+
+    auto in_use_iter = in_use_.find(index);
+    if (in_use_iter != in_use_.end() && covers(*in_use_iter->second.document, scan_query)) {
+        in_use_iter->second.requested = true;
+        return in_use_iter->second.document;
+    }
+
+    // Collect a finished job; a cancelled one leaves no result and is restarted below
+    auto pending_iter = pending_.find(index);
+    if (pending_iter != pending_.end()) {
+        PendingJob& job = *pending_iter->second;
+        if (!job.done.load(std::memory_order_acquire)) {
+            job.requested = true;
+            job.prefetch = false; // Needed now: no longer cancelled with the prefetch
+            return nullptr;
+        }
+        std::shared_ptr<const MaterializedDocument> result = std::move(job.result);
+        pending_.erase(pending_iter);
+        if (result) {
+            cache_.insert(index, result, result->memory_bytes());
+            if (covers(*result, scan_query)) {
+                in_use_[index] = {result, true};
+                return result;
+            }
+        }
+    }
+
+    std::shared_ptr<const FormattedJson> formatted;
+    if (const auto* cached = cache_.find(index)) {
+        if (covers(**cached, scan_query)) {
+            in_use_[index] = {*cached, true};
+            return *cached;
+        }
+        formatted = (*cached)->formatted; // Only the scan is missing
+    } else if (in_use_iter != in_use_.end()) {
+        formatted = in_use_iter->second.document->formatted;
+    }
+
+    start_job(snapshot, index, scan_query, std::move(formatted), JobPriority::High);
+    return nullptr;
+}
+
+void DocumentFormatter::prefetch(const DatasetSnapshot& snapshot, size_t index) {
+    sync_generation(snapshot);
+    if (in_use_.contains(index) || pending_.contains(index) ||
+        cache_.find(index, CacheHint::Scan) != nullptr) {
+        return;
+    }
+    start_job(snapshot, index, {}, nullptr, JobPriority::Low);
+    PendingJob& job = *pending_.at(index);
+    job.requested = false;
+    job.prefetch = true;
+}
+
+void DocumentFormatter::cancel_prefetch() {
+    std::erase_if(pending_, [](const auto& entry) {
+        if (entry.second->prefetch) {
+            entry.second->handle.cancel();
+            return true;
+        }
+        return false;
+    });
+}
+
+void DocumentFormatter::sync_generation(const DatasetSnapshot& snapshot) {
+    if (snapshot.generation() != generation_) {
+        clear();
+        generation_ = snapshot.generation();
+    }
+}
+
+void DocumentFormatter::start_job(const DatasetSnapshot& snapshot, size_t index,
+                                  const SearchQuery& scan_query,
+                                  std::shared_ptr<const FormattedJson> formatted,
+                                  JobPriority priority) {
+    auto job = std::make_shared<PendingJob>();
+    job->scan_query = scan_query;
+    job->total_bytes = snapshot.document(index).size();
+    pending_[index] = job;
+
+    job->handle = get_job_system().submit(
+        priority, [job, snapshot, index, formatted](const CancellationToken& token) {
+            std::string_view raw = snapshot.document(index);
+            auto document = std::make_shared<MaterializedDocument>();
+            document->formatted = formatted;
+            if (!document->formatted) {
+                auto progress = [&](size_t bytes_done) {
+                    job->bytes_done.store(bytes_done, std::memory_order_relaxed);
+                    request_ui_wake(); // Keep the progress bar moving while the UI idles
+                    return !token.is_cancelled();
+                };
+                document->formatted = std::make_shared<const FormattedJson>(
+                    format_json(raw, true, std::pmr::get_default_resource(), progress));
+            }
+            if (!token.is_cancelled() && !job->scan_query.text.empty()) {
+                std::pmr::vector<uint64_t> offsets;
+                find_matches(job->scan_query, raw, offsets);
+                document->scanned_query = job->scan_query;
+                document->scanned_offsets.assign(offsets.begin(), offsets.end());
+            }
+            if (!token.is_cancelled()) {
+                job->result = std::move(document);
+            }
+            job->done.store(true, std::memory_order_release);
+        });
+}
+
+float DocumentFormatter::progress(size_t index) const {
+    auto pending_iter = pending_.find(index);
+    if (pending_iter == pending_.end() || pending_iter->second->total_bytes == 0) {
+        return 0.0F;
+    }
+    const PendingJob& job = *pending_iter->second;
+    return static_cast<float>(job.bytes_done.load(std::memory_order_relaxed)) /
+           static_cast<float>(job.total_bytes);
+}
+
+void DocumentFormatter::clear() {
+    for (auto& [index, job] : pending_) {
+        job->handle.cancel();
+    }
+    pending_.clear();
+    in_use_.clear();
+    cache_.clear();
+}
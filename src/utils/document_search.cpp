@@ -0,0 +1,93 @@
+#include "utils/document_search.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+bool document_matches(const SearchQuery& query, std::string_view document) {
+    switch (query.kind) {
+    case SearchKind::Substring:
+        return document.find(query.text) != std::string_view::npos;
+    }
+    return false;
+}
+
+size_t find_matches(const SearchQuery& query, std::string_view document,
+                    std::pmr::vector<uint64_t>& offsets) {
+    size_t count = 0;
+    switch (query.kind) {
+    case SearchKind::Substring: {
+        if (query.text.empty()) {
+            return 0;
+        }
+        size_t pos = document.find(query.text);
+        while (pos != std::string_view::npos) {
+            offsets.push_back(pos);
+            count++;
+            pos = document.find(query.text, pos + query.text.size());
+        }
+        break;
+    }
+    }
+    return count;
+}
+
+size_t match_length(const SearchQuery& query) {
+    return query.text.size();
+}
+
+// === MatchOffsets ===
+
+void MatchOffsets::add_document(uint64_t doc_index, std::span<const uint64_t> offsets) {
+    if (truncated_ || offsets_.size() + offsets.size() > MAX_OFFSETS) {
+        truncated_ = true;
+        return;
+    }
+    documents_.push_back(doc_index);
+    starts_.push_back(offsets_.size());
+    offsets_.insert(offsets_.end(), offsets.begin(), offsets.end());
+}
+
+void MatchOffsets::append(const MatchOffsets& later) {
+    if (truncated_ || offsets_.size() + later.offsets_.size() > MAX_OFFSETS) {
+        truncated_ = true;
+        return;
+    }
+    size_t base = offsets_.size();
+    documents_.insert(documents_.end(), later.documents_.begin(), later.documents_.end());
+    for (size_t start : later.starts_) {
+        starts_.push_back(base + start);
+    }
+    offsets_.insert(offsets_.end(), later.offsets_.begin(), later.offsets_.end());
+    truncated_ = later.truncated_;
+}
+
+std::span<const uint64_t> MatchOffsets::find(uint64_t doc_index) const {
+    auto iter = std::lower_bound(documents_.begin(), documents_.end(), doc_index);
+    if (iter == documents_.end() || *iter != doc_index) {
+        return {};
+    }
+    auto pos = static_cast<size_t>(std::distance(documents_.begin(), iter));
+    size_t end = pos + 1 < starts_.size() ? starts_[pos + 1] : offsets_.size();
+    return {offsets_.data() + starts_[pos], end - starts_[pos]};
+}
+
+bool MatchOffsets::is_recorded(uint64_t doc_index) const {
+    return std::binary_search(documents_.begin(), documents_.end(), doc_index);
+}
+
+void MatchOffsets::clear() {
+    documents_.clear();
+    starts_.clear();
+    offsets_.clear();
+    truncated_ = false;
+}
+
+size_t MatchOffsets::memory_bytes() const {
+    return documents_.capacity() * sizeof(uint64_t) + starts_.capacity() * sizeof(size_t) +
+           offsets_.capacity() * sizeof(uint64_t);
+}
+
+void SearchResults::clear() {
+    matches.clear();
+    offsets.clear();
+}
@@ -0,0 +1,48 @@
+#include "utils/frame_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity)
+    : buffer_(std::make_unique_for_overwrite<std::byte[]>(capacity)), capacity_(capacity) {}
+
+void FrameArena::reset() {
+    size_t frame_bytes = bytes_used();
+    peak_bytes_ = std::max(peak_bytes_, frame_bytes);
+    if (!overflow_.empty()) {
+        // Outgrown: size the buffer so a frame like this one fits next time
+        overflow_.clear();
+        capacity_ = std::max(capacity_ * 2, frame_bytes);
+        buffer_ = std::make_unique_for_overwrite<std::byte[]>(capacity_);
+        low_frames_ = 0;
+    } else if (capacity_ > INITIAL_CAPACITY && frame_bytes <= capacity_ / LOW_WATER_DIVISOR) {
+        low_peak_bytes_ = low_frames_ == 0 ? frame_bytes : std::max(low_peak_bytes_, frame_bytes);
+        if (++low_frames_ >= DECAY_FRAMES) {
+            // The big frames are gone: give the memory back
+            capacity_ = std::max(low_peak_bytes_ * 2, INITIAL_CAPACITY);
+            buffer_ = std::make_unique_for_overwrite<std::byte[]>(capacity_);
+            low_frames_ = 0;
+        }
+    } else {
+        low_frames_ = 0;
+    }
+    offset_ = 0;
+    overflow_bytes_ = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    auto base = reinterpret_cast<uintptr_t>(buffer_.get());
+    uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    size_t end = static_cast<size_t>(aligned - base) + bytes;
+    if (end <= capacity_) {
+        offset_ = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Overflow: serve from the heap until reset() folds it into the buffer
+    size_t block_size = bytes + alignment;
+    overflow_.push_back(std::make_unique_for_overwrite<std::byte[]>(block_size));
+    overflow_bytes_ += block_size;
+    void* block = overflow_.back().get();
+    return std::align(alignment, bytes, block, block_size);
+}
@@ -0,0 +1,96 @@
+#include "utils/frame_scheduler.hpp"
+
+#include "utils/trace.hpp"
+
+#include <algorithm>
+#include <utility>
+
+FrameScheduler& FrameScheduler::instance() {
+    static FrameScheduler scheduler;
+    return scheduler;
+}
+
+FrameScheduler& get_frame_scheduler() {
+    return FrameScheduler::instance();
+}
+
+FrameScheduler::JobId FrameScheduler::add(std::string name, StepFn step) {
+    JobId job_id = next_id_++;
+    jobs_.push_back({job_id, std::move(name), std::move(step)});
+    return job_id;
+}
+
+void FrameScheduler::cancel(JobId job_id) {
+    for (Job& job : jobs_) {
+        if (job.id == job_id) {
+            job.finished = true;
+        }
+    }
+}
+
+bool FrameScheduler::is_running(JobId job_id) const {
+    return std::any_of(jobs_.begin(), jobs_.end(),
+                       [job_id](const Job& job) { return job.id == job_id && !job.finished; });
+}
+
+void FrameScheduler::begin_frame() {
+    frame_start_ = Clock::now();
+}
+
+size_t FrameScheduler::batch_for(const Job& job, Clock::duration budget) {
+    if (job.ns_per_unit <= 0.0) {
+        return 1; // Unknown cost: measure with a single unit first
+    }
+    double budget_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(budget).count());
+    auto units = static_cast<size_t>(budget_ns / job.ns_per_unit);
+    return std::clamp<size_t>(units, 1, MAX_BATCH);
+}
+
+void FrameScheduler::run_frame() {
+    TRACE_SCOPE("scheduler");
+    Clock::time_point work_start = Clock::now();
+    Clock::duration budget = FRAME_TARGET - RENDER_RESERVE - (work_start - frame_start_);
+    budget = std::max<Clock::duration>(budget, MIN_WORK_BUDGET);
+    Clock::time_point deadline = work_start + budget;
+
+    // Keep handing out batches until the budget is spent or every job is idle
+    made_progress_ = false;
+    bool any_progress = true;
+    while (any_progress && !jobs_.empty()) {
+        any_progress = false;
+        for (size_t i = 0; i < jobs_.size(); i++) {
+            Clock::time_point now = Clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            Job& job = jobs_[(next_job_ + i) % jobs_.size()];
+            if (job.finished) {
+                continue;
+            }
+
+            // Split what is left of the budget evenly between the remaining jobs
+            auto share = (deadline - now) / static_cast<Clock::rep>(jobs_.size() - i);
+            JobStep result = job.step(batch_for(job, share));
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - now);
+
+            if (result.units_done > 0) {
+                double sample =
+                    static_cast<double>(elapsed.count()) / static_cast<double>(result.units_done);
+                job.ns_per_unit = job.ns_per_unit <= 0.0
+                                      ? sample
+                                      : (1.0 - COST_SMOOTHING) * job.ns_per_unit +
+                                            COST_SMOOTHING * sample;
+                any_progress = true;
+                made_progress_ = true;
+            }
+            job.finished = job.finished || result.finished;
+        }
+        if (!jobs_.empty()) {
+            next_job_ = (next_job_ + 1) % jobs_.size();
+        }
+    }
+
+    std::erase_if(jobs_, [](const Job& job) { return job.finished; });
+    last_work_time_ = Clock::now() - work_start;
+}
@@ -0,0 +1,141 @@
+#include "utils/height_index.hpp"
+
+#include <bit>
+#include <iterator>
+
+namespace {
+uint64_t block_count(uint64_t rows) {
+    return (rows + HeightIndex::BLOCK_ROWS - 1) / HeightIndex::BLOCK_ROWS;
+}
+} // namespace
+
+void HeightIndex::reset(uint64_t row_count, double default_height) {
+    row_count_ = row_count;
+    default_height_ = default_height;
+    deltas_.clear();
+    tree_.assign(block_count(row_count) + 1, 0.0);
+}
+
+void HeightIndex::resize(uint64_t row_count) {
+    if (row_count == row_count_) {
+        return;
+    }
+    row_count_ = row_count;
+    deltas_.erase(deltas_.lower_bound(row_count), deltas_.end());
+    rebuild_tree();
+}
+
+void HeightIndex::rebuild_tree() {
+    tree_.assign(block_count(row_count_) + 1, 0.0);
+    for (const auto& [row, delta] : deltas_) {
+        tree_[row / BLOCK_ROWS + 1] += delta;
+    }
+    // Linear-time Fenwick construction: push each node into its parent
+    for (size_t node = 1; node < tree_.size(); node++) {
+        size_t parent = node + (node & (~node + 1));
+        if (parent < tree_.size()) {
+            tree_[parent] += tree_[node];
+        }
+    }
+}
+
+void HeightIndex::add_block_delta(uint64_t block, double delta) {
+    for (size_t node = block + 1; node < tree_.size(); node += node & (~node + 1)) {
+        tree_[node] += delta;
+    }
+}
+
+double HeightIndex::block_delta_prefix(uint64_t blocks) const {
+    double sum = 0.0;
+    for (size_t node = blocks; node > 0; node &= node - 1) {
+        sum += tree_[node];
+    }
+    return sum;
+}
+
+void HeightIndex::set_height(uint64_t row, double height) {
+    if (row >= row_count_) {
+        return;
+    }
+    double delta = height - default_height_;
+    auto iter = deltas_.find(row);
+    double old_delta = iter != deltas_.end() ? iter->second : 0.0;
+    if (delta == old_delta) {
+        return;
+    }
+
+    if (delta == 0.0) {
+        deltas_.erase(iter);
+    } else if (iter != deltas_.end()) {
+        iter->second = delta;
+    } else {
+        deltas_.emplace(row, delta);
+    }
+    add_block_delta(row / BLOCK_ROWS, delta - old_delta);
+}
+
+double HeightIndex::height(uint64_t row) const {
+    auto iter = deltas_.find(row);
+    return default_height_ + (iter != deltas_.end() ? iter->second : 0.0);
+}
+
+double HeightIndex::offset_of(uint64_t row) const {
+    uint64_t block = row / BLOCK_ROWS;
+    double offset = static_cast<double>(row) * default_height_ + block_delta_prefix(block);
+    // Measured rows earlier in the same block
+    for (auto iter = deltas_.lower_bound(block * BLOCK_ROWS);
+         iter != deltas_.end() && iter->first < row; ++iter) {
+        offset += iter->second;
+    }
+    return offset;
+}
+
+uint64_t HeightIndex::row_at(double offset) const {
+    if (row_count_ == 0 || offset <= 0.0) {
+        return 0;
+    }
+
+    // Fenwick descent for the last block starting at or above `offset`.
+    // A node spanning `step` blocks adds their deltas plus step full blocks of default rows.
+    double block_height = static_cast<double>(BLOCK_ROWS) * default_height_;
+    size_t block = 0;
+    double block_top = 0.0;
+    for (size_t step = std::bit_floor(tree_.size() - 1); step > 0; step >>= 1) {
+        size_t next = block + step;
+        if (next < tree_.size()) {
+            double next_top = block_top + static_cast<double>(step) * block_height + tree_[next];
+            if (next_top <= offset) {
+                block = next;
+                block_top = next_top;
+            }
+        }
+    }
+
+    // Walk the block: default rows are skipped arithmetically, measured rows one at a time
+    uint64_t row = block * BLOCK_ROWS;
+    double row_top = block_top;
+    auto iter = deltas_.lower_bound(row);
+    while (row < row_count_) {
+        uint64_t next_measured = iter != deltas_.end() ? iter->first : row_count_;
+        if (next_measured > row) {
+            // Rows [row, next_measured) all have the default height
+            if (default_height_ > 0.0) {
+                auto skip = static_cast<uint64_t>((offset - row_top) / default_height_);
+                if (skip < next_measured - row) {
+                    return row + skip;
+                }
+            }
+            row_top += static_cast<double>(next_measured - row) * default_height_;
+            row = next_measured;
+            continue;
+        }
+        double row_height = default_height_ + iter->second;
+        if (offset < row_top + row_height) {
+            return row;
+        }
+        row_top += row_height;
+        row++;
+        iter = std::next(iter);
+    }
+    return row_count_ - 1;
+}
@@ -0,0 +1,133 @@
+#include "utils/index_file.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+
+namespace {
+constexpr std::array<char, 8> INDEX_MAGIC = {'J', 'V', 'I', 'D', 'X', '0', '0', '1'};
+constexpr const char* INDEX_EXTENSION = ".jvidx";
+
+static_assert(sizeof(DocumentIndex) == 2 * sizeof(uint64_t), "DocumentIndex is written as-is");
+
+struct IndexHeader {
+    std::array<char, 8> magic = INDEX_MAGIC;
+    uint64_t source_size = 0;
+    int64_t source_mtime = 0;
+    uint64_t raw_size = 0;
+    uint64_t document_count = 0;
+};
+
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+bool stat_source(const std::string& file_path, SourceStamp& stamp) {
+    std::error_code error;
+    stamp.size = std::filesystem::file_size(file_path, error);
+    if (error) {
+        return false;
+    }
+    auto mtime = std::filesystem::last_write_time(file_path, error);
+    if (error) {
+        return false;
+    }
+    stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+struct FileCloser {
+    void operator()(std::FILE* file) const { std::fclose(file); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+} // namespace
+
+std::string index_file_path(const std::string& file_path) {
+    return file_path + INDEX_EXTENSION;
+}
+
+bool save_index_file(const std::string& file_path, const DatasetSnapshot& snapshot) {
+    SourceStamp stamp;
+    if (!snapshot.valid() || !stat_source(file_path, stamp)) {
+        return false;
+    }
+
+    // Written to a temporary name and renamed, so readers never see a partial index
+    std::string final_path = index_file_path(file_path);
+    std::string temp_path = final_path + ".tmp";
+    std::span<const DocumentIndex> documents = snapshot.index();
+    {
+        FilePtr file(std::fopen(temp_path.c_str(), "wb"));
+        if (!file) {
+            return false;
+        }
+        IndexHeader header;
+        header.source_size = stamp.size;
+        header.source_mtime = stamp.mtime;
+        header.raw_size = snapshot.raw_size();
+        header.document_count = documents.size();
+        bool written =
+            std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+            std::fwrite(documents.data(), sizeof(DocumentIndex), documents.size(), file.get()) ==
+                documents.size();
+        if (!written || std::fflush(file.get()) != 0) {
+            file.reset();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, final_path, error);
+    return !error;
+}
+
+bool load_index_file(const std::string& file_path, size_t raw_size,
+                     std::vector<DocumentIndex>& index) {
+    SourceStamp stamp;
+    if (!stat_source(file_path, stamp)) {
+        return false;
+    }
+    std::string path = index_file_path(file_path);
+    std::error_code error;
+    uint64_t file_size = std::filesystem::file_size(path, error);
+    FilePtr file(std::fopen(path.c_str(), "rb"));
+    if (error || !file) {
+        return false;
+    }
+
+    IndexHeader header;
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 || header.magic != INDEX_MAGIC ||
+        header.source_size != stamp.size || header.source_mtime != stamp.mtime ||
+        header.raw_size != raw_size) {
+        return false;
+    }
+    // The count must match the entries actually present before it sizes an allocation
+    uint64_t entry_bytes = file_size - sizeof(header);
+    if (entry_bytes % sizeof(DocumentIndex) != 0 ||
+        entry_bytes / sizeof(DocumentIndex) != header.document_count) {
+        return false;
+    }
+
+    std::vector<DocumentIndex> documents(header.document_count);
+    if (std::fread(documents.data(), sizeof(DocumentIndex), documents.size(), file.get()) !=
+        documents.size()) {
+        return false;
+    }
+    // Never hand out views past the buffer, whatever the file says
+    for (const DocumentIndex& document : documents) {
+        if (document.byte_offset_ > raw_size ||
+            document.byte_length_ > raw_size - document.byte_offset_) {
+            return false;
+        }
+    }
+    index = std::move(documents);
+    return true;
+}
@@ -0,0 +1,218 @@
+#include "utils/job_system.hpp"
+
+#include "utils/parser_pool.hpp"
+#include "utils/trace.hpp"
+#include "utils/ui_wake.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+namespace {
+// Trace scope names, by JobPriority
+constexpr std::array<const char*, 3> JOB_TRACE_NAMES = {"job_high", "job_normal", "job_low"};
+
+#ifdef __linux__
+// CPU limit from the cgroup quota, or 0 if unlimited/unknown
+size_t cgroup_cpu_limit() {
+    // cgroup v2: "<quota> <period>" or "max <period>"
+    std::ifstream cpu_max("/sys/fs/cgroup/cpu.max");
+    std::string quota;
+    double period = 0.0;
+    if (cpu_max >> quota >> period && quota != "max" && period > 0.0) {
+        return static_cast<size_t>(std::ceil(std::stod(quota) / period));
+    }
+
+    // cgroup v1
+    std::ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+    std::ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+    double quota_us = 0.0;
+    double period_us = 0.0;
+    if (quota_file >> quota_us && period_file >> period_us && quota_us > 0.0 && period_us > 0.0) {
+        return static_cast<size_t>(std::ceil(quota_us / period_us));
+    }
+    return 0;
+}
+#endif
+} // namespace
+
+size_t available_cpu_count() {
+    size_t count = std::max(1U, std::thread::hardware_concurrency());
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        count = std::max(1, CPU_COUNT(&cpu_set));
+    }
+    size_t limit = cgroup_cpu_limit();
+    if (limit > 0) {
+        count = std::min(count, limit);
+    }
+#endif
+    return count;
+}
+
+// === JobHandle ===
+
+bool JobHandle::is_done() const {
+    if (!state_) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->done;
+}
+
+void JobHandle::wait() const {
+    if (!state_) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done_cv.wait(lock, [this]() { return state_->done; });
+}
+
+void JobHandle::cancel() const {
+    if (state_) {
+        state_->token.cancel();
+    }
+}
+
+CancellationToken JobHandle::token() const {
+    return state_ ? state_->token : CancellationToken{};
+}
+
+// === JobSystem ===
+
+JobSystem& JobSystem::instance() {
+    static JobSystem system;
+    return system;
+}
+
+JobSystem& get_job_system() {
+    return JobSystem::instance();
+}
+
+JobSystem::JobSystem() {
+    size_t count = std::max(MIN_WORKERS, available_cpu_count());
+    running_.resize(count);
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        workers_.emplace_back([this, i]() { worker_loop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+JobHandle JobSystem::submit(JobPriority priority, JobFn job, CancellationToken token) {
+    auto state = std::make_shared<JobHandle::State>();
+    state->token = std::move(token);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            state->done = true;
+            return JobHandle(state);
+        }
+        queues_.at(static_cast<size_t>(priority)).push_back({std::move(job), state});
+        if (trace_enabled()) {
+            size_t queued = 0;
+            for (const auto& queue : queues_) {
+                queued += queue.size();
+            }
+            trace_counter("queued_jobs", static_cast<double>(queued));
+        }
+    }
+    work_cv_.notify_one();
+    return JobHandle(state);
+}
+
+void JobSystem::finish(JobHandle::State& state) {
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.done = true;
+    }
+    state.done_cv.notify_all();
+}
+
+void JobSystem::worker_loop(size_t worker_index) {
+    trace_thread_name("worker " + std::to_string(worker_index));
+    while (true) {
+        Task task;
+        size_t priority = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]() {
+                return stopping_ || std::any_of(queues_.begin(), queues_.end(),
+                                                [](const auto& queue) { return !queue.empty(); });
+            });
+            if (stopping_) {
+                return;
+            }
+            // Highest priority first, FIFO within a priority
+            for (; priority < queues_.size(); priority++) {
+                auto& queue = queues_[priority];
+                if (!queue.empty()) {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                    break;
+                }
+            }
+            running_[worker_index] = task.state;
+        }
+
+        if (!task.state->token.is_cancelled()) {
+            TRACE_SCOPE(JOB_TRACE_NAMES.at(priority));
+            task.job(task.state->token);
+        }
+        // A job's parse results are gone once it returns; don't keep its buffers pinned
+        trim_local_parsers();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_[worker_index].reset();
+        }
+        finish(*task.state);
+        // Finished work (search chunks, formatting, loads) usually changes what the UI shows
+        request_ui_wake();
+    }
+}
+
+void JobSystem::shutdown() {
+    std::vector<Task> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        for (auto& queue : queues_) {
+            for (Task& task : queue) {
+                dropped.push_back(std::move(task));
+            }
+            queue.clear();
+        }
+        for (const auto& state : running_) {
+            if (state) {
+                state->token.cancel();
+            }
+        }
+    }
+    work_cv_.notify_all();
+
+    for (Task& task : dropped) {
+        task.state->token.cancel();
+        finish(*task.state);
+    }
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
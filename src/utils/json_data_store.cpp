@@ -1,5 +1,12 @@
 #include "utils/json_data_store.hpp"
 
+#include "utils/memory_stats.hpp"
+
+REGISTER_MEMORY_REPORTER(raw_data, [] { return get_json_data().raw_data_bytes(); });
+REGISTER_MEMORY_REPORTER(document_index, [] { return get_json_data().index_bytes(); });
+REGISTER_MEMORY_REPORTER(document_cache,
+                         [] { return get_json_data().document_cache_stats().bytes; });
+
 JsonDataStore& JsonDataStore::instance() {
     static JsonDataStore store;
     return store;
@@ -11,31 +18,23 @@ JsonDataStore& get_json_data() {
 
 void JsonDataStore::reset() {
     std::lock_guard<std::mutex> lock(mutex_);
-    raw_data_.reset();
-    index_.clear();
-    cache_list_.clear();
-    cache_map_.clear();
+    dataset_.reset();
+    cache_.clear();
     is_ready_ = false;
     generation_++;
 }
 
-void JsonDataStore::set_raw_data(simdjson::padded_string&& data) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    raw_data_ = std::make_unique<simdjson::padded_string>(std::move(data));
-}
-
-void JsonDataStore::add_document_index(size_t offset, size_t length) {
+void JsonDataStore::publish(std::shared_ptr<const Dataset> dataset) {
     std::lock_guard<std::mutex> lock(mutex_);
-    index_.push_back({offset, length});
-}
-
-void JsonDataStore::set_complete() {
-    is_ready_ = true;
+    dataset_ = std::move(dataset);
+    cache_.clear();
+    generation_++;
+    is_ready_ = dataset_ != nullptr;
 }
 
 size_t JsonDataStore::document_count() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return index_.size();
+    return dataset_ ? dataset_->index.size() : 0;
 }
 
 bool JsonDataStore::is_ready() const {
@@ -46,43 +45,44 @@ size_t JsonDataStore::generation() const {
     return generation_.load();
 }
 
-std::string JsonDataStore::get_document(size_t index) {
+DatasetSnapshot JsonDataStore::snapshot() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return get_cached_or_parse(index);
+    return {dataset_, generation_.load()};
 }
 
-std::string JsonDataStore::get_cached_or_parse(size_t index) const {
+std::string JsonDataStore::get_document(size_t index, CacheHint hint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     // Check cache first
-    auto cache_iter = cache_map_.find(index);
-    if (cache_iter != cache_map_.end()) {
-        // Move to front (most recently used)
-        cache_list_.splice(cache_list_.begin(), cache_list_, cache_iter->second);
-        return cache_iter->second->second;
+    if (const std::string* cached = cache_.find(index, hint)) {
+        return *cached;
     }
 
-    // Not in cache, parse from raw data
-    if (index >= index_.size() || !raw_data_) {
+    // Not in cache, copy from raw data
+    if (!dataset_ || index >= dataset_->index.size()) {
         return "";
     }
 
-    const DocumentIndex& doc_idx = index_.at(index);
-    std::string doc(raw_data_->data() + doc_idx.byte_offset_, doc_idx.byte_length_);
+    const DocumentIndex& doc_idx = dataset_->index.at(index);
+    std::string doc(dataset_->raw_data.data() + doc_idx.byte_offset_, doc_idx.byte_length_);
 
-    // Add to cache
-    add_to_cache(index, doc);
+    // Scans are not admitted, so they cannot flush what the user is looking at
+    cache_.insert(index, doc, doc.size(), hint);
 
     return doc;
 }
 
-void JsonDataStore::add_to_cache(size_t index, const std::string& doc) const {
-    // Evict oldest if cache is full
-    if (cache_list_.size() >= CACHE_SIZE) {
-        size_t oldest_index = cache_list_.back().first;
-        cache_map_.erase(oldest_index);
-        cache_list_.pop_back();
-    }
+CacheStats JsonDataStore::document_cache_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.stats();
+}
 
-    // Add to front
-    cache_list_.emplace_front(index, doc);
-    cache_map_[index] = cache_list_.begin();
+size_t JsonDataStore::raw_data_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dataset_ ? dataset_->raw_data.size() + simdjson::SIMDJSON_PADDING : 0;
+}
+
+size_t JsonDataStore::index_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dataset_ ? dataset_->index.capacity() * sizeof(DocumentIndex) : 0;
 }
@@ -0,0 +1,178 @@
+#include "utils/json_formatter.hpp"
+
+#include "utils/parser_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <iterator>
+#include <simdjson.h>
+
+namespace {
+constexpr size_t INDENT_SIZE = 2;
+
+bool is_json_whitespace(char chr) {
+    return chr == ' ' || chr == '\t' || chr == '\n' || chr == '\r';
+}
+
+void collect_line_starts(FormattedJson& result) {
+    result.line_starts.assign(1, 0);
+    for (size_t i = 0; i < result.text.size(); i++) {
+        if (result.text[i] == '\n') {
+            result.line_starts.push_back(i + 1);
+        }
+    }
+}
+} // namespace
+
+void PositionMap::add(size_t raw_offset, size_t pretty_offset) {
+    if (!checkpoints_.empty()) {
+        const auto& [last_raw, last_pretty] = checkpoints_.back();
+        if (pretty_offset - last_pretty == raw_offset - last_raw) {
+            return; // Same delta, already covered by the previous checkpoint
+        }
+    }
+    checkpoints_.emplace_back(raw_offset, pretty_offset);
+}
+
+size_t PositionMap::to_pretty(size_t raw_offset) const {
+    auto iter = std::upper_bound(
+        checkpoints_.begin(), checkpoints_.end(), raw_offset,
+        [](size_t offset, const std::pair<size_t, size_t>& point) { return offset < point.first; });
+    if (iter == checkpoints_.begin()) {
+        return raw_offset;
+    }
+    const auto& [raw, pretty] = *std::prev(iter);
+    return pretty + (raw_offset - raw);
+}
+
+size_t FormattedJson::line_of(size_t pretty_offset) const {
+    auto iter = std::upper_bound(line_starts.begin(), line_starts.end(), pretty_offset);
+    return static_cast<size_t>(std::distance(line_starts.begin(), iter)) - 1;
+}
+
+FormattedJson format_json(std::string_view raw_json, bool input_is_padded,
+                          std::pmr::memory_resource* memory, const FormatProgressFn& progress) {
+    FormattedJson result(memory);
+
+    simdjson::dom::parser& parser = local_dom_parser(raw_json.size());
+    auto doc = parser.parse(raw_json.data(), raw_json.size(), !input_is_padded);
+    if (doc.error() != simdjson::SUCCESS) {
+        result.text = raw_json; // Return as-is if parsing fails
+        collect_line_starts(result);
+        return result;
+    }
+
+    std::pmr::string& out = result.text;
+    out.reserve(raw_json.size() + raw_json.size() / 2);
+    result.line_starts.push_back(0);
+
+    size_t indent = 0;
+    bool in_string = false;
+    bool escaped = false;
+
+    auto emit = [&](size_t raw_offset, char chr) {
+        result.positions.add(raw_offset, out.size());
+        out.push_back(chr);
+    };
+    auto newline = [&]() {
+        out.push_back('\n');
+        result.line_starts.push_back(out.size());
+        out.append(indent, ' ');
+    };
+
+    size_t next_report = FORMAT_PROGRESS_INTERVAL;
+    for (size_t i = 0; i < raw_json.size(); i++) {
+        if (i >= next_report && progress) {
+            if (!progress(i)) {
+                return FormattedJson(memory);
+            }
+            next_report += FORMAT_PROGRESS_INTERVAL;
+        }
+        char chr = raw_json[i];
+
+        if (in_string) {
+            emit(i, chr);
+            if (escaped) {
+                escaped = false;
+            } else if (chr == '\\') {
+                escaped = true;
+            } else if (chr == '"') {
+                in_string = false;
+            }
+            continue;
+        }
+
+        if (is_json_whitespace(chr)) {
+            continue;
+        }
+
+        switch (chr) {
+        case '"':
+            in_string = true;
+            emit(i, chr);
+            break;
+        case '{':
+        case '[': {
+            emit(i, chr);
+            // Keep empty containers on one line
+            size_t next = i + 1;
+            while (next < raw_json.size() && is_json_whitespace(raw_json[next])) {
+                next++;
+            }
+            char close = chr == '{' ? '}' : ']';
+            if (next < raw_json.size() && raw_json[next] == close) {
+                emit(next, close);
+                i = next;
+                break;
+            }
+            indent += INDENT_SIZE;
+            newline();
+            break;
+        }
+        case '}':
+        case ']':
+            indent = indent >= INDENT_SIZE ? indent - INDENT_SIZE : 0;
+            newline();
+            emit(i, chr);
+            break;
+        case ',':
+            emit(i, chr);
+            newline();
+            break;
+        case ':':
+            emit(i, chr);
+            out.push_back(' ');
+            break;
+        default:
+            emit(i, chr);
+            break;
+        }
+    }
+
+    return result;
+}
+
+void append_json_string(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::array<char, 8> escaped{};
+            std::snprintf(escaped.data(), escaped.size(), "\\u%04x",
+                          static_cast<unsigned char>(c));
+            out += escaped.data();
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+std::string json_string(std::string_view text) {
+    std::string out;
+    append_json_string(out, text);
+    return out;
+}
@@ -1,11 +1,22 @@
 #include "utils/json_parser.hpp"
 
+#include "utils/index_file.hpp"
 #include "utils/json_data_store.hpp"
 #include "utils/loading_state.hpp"
+#include "utils/parser_pool.hpp"
+#include "utils/trace.hpp"
+#include "utils/ui_wake.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
-#include <iostream>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <simdjson.h>
 #include <sstream>
 #include <string>
@@ -18,6 +29,19 @@ constexpr double BYTES_TO_GB = 1024.0 * 1024.0 * 1024.0;
 constexpr size_t BATCH_SIZE = 1024ULL * 1024ULL; // 1MB batch for NDJSON
 constexpr size_t PROGRESS_INTERVAL = 100000;
 constexpr size_t GZ_BUFFER_SIZE = 128 * 1024; // 128KB read buffer
+constexpr size_t READ_CHUNK_SIZE = 4ULL * 1024ULL * 1024ULL; // 4MB per read() of plain files
+
+// Loads share the parser and the data store, so they run one at a time. The
+// load job takes its file from `requested_load` when it starts (the latest
+// request wins) and, if another was requested meanwhile, submits the next job
+// when it finishes, so no worker ever blocks waiting for another load.
+// All guarded by load_mutex.
+std::mutex load_mutex;
+std::optional<std::string> requested_load;
+JobHandle current_load;
+bool load_active = false;  // A load job is queued or running
+bool load_started = false; // ... and has taken its file
+std::atomic<bool> print_load_summary{false};
 
 bool ends_with(const std::string& str, const std::string& suffix) {
     if (suffix.size() > str.size()) {
@@ -26,10 +50,16 @@ bool ends_with(const std::string& str, const std::string& suffix) {
     return str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
 }
 
-std::string decompress_gzip(const std::string& file_path) {
+// Returns an empty string on error or cancellation
+std::string decompress_gzip(const std::string& file_path, const CancellationToken& token) {
     LoadingState& state = get_loading_state();
     state.status_message = "Decompressing gzip file...";
 
+    // Progress is measured on the compressed input; 0 (unknown) if stat fails
+    std::error_code size_error;
+    auto compressed_size = static_cast<size_t>(std::filesystem::file_size(file_path, size_error));
+    state.begin_phase(LoadPhase::Decompress, size_error ? 0 : compressed_size);
+
     gzFile gz_file = gzopen(file_path.c_str(), "rb");
     if (gz_file == nullptr) {
         state.error_message = "Error opening gzip file";
@@ -40,14 +70,56 @@ std::string decompress_gzip(const std::string& file_path) {
     std::array<char, GZ_BUFFER_SIZE> buffer{};
     int bytes_read = 0;
 
-    while ((bytes_read = gzread(gz_file, buffer.data(), GZ_BUFFER_SIZE)) > 0) {
+    // Checked once per buffer, so a cancel stops inflating within a few milliseconds
+    while (!token.is_cancelled() &&
+           (bytes_read = gzread(gz_file, buffer.data(), GZ_BUFFER_SIZE)) > 0) {
         result.append(buffer.data(), static_cast<size_t>(bytes_read));
+        z_off_t consumed = gzoffset(gz_file);
+        if (consumed >= 0) {
+            state.advance_phase(static_cast<size_t>(consumed));
+            request_ui_wake();
+        }
     }
 
     gzclose(gz_file);
+    if (token.is_cancelled()) {
+        return "";
+    }
     return result;
 }
 
+// Reads the whole file in chunks so a cancel is noticed between chunks
+bool read_file(const std::string& file_path, simdjson::padded_string& out,
+               const CancellationToken& token) {
+    std::error_code size_error;
+    auto file_size = static_cast<size_t>(std::filesystem::file_size(file_path, size_error));
+    if (size_error) {
+        return false;
+    }
+
+    std::FILE* file = std::fopen(file_path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    LoadingState& state = get_loading_state();
+    state.begin_phase(LoadPhase::Read, file_size);
+    out = simdjson::padded_string(file_size);
+    size_t total_read = 0;
+    while (total_read < file_size && !token.is_cancelled()) {
+        size_t chunk = std::min(READ_CHUNK_SIZE, file_size - total_read);
+        size_t bytes_read = std::fread(out.data() + total_read, 1, chunk, file);
+        if (bytes_read == 0) {
+            break;
+        }
+        total_read += bytes_read;
+        state.advance_phase(total_read);
+        request_ui_wake();
+    }
+    std::fclose(file);
+    return total_read == file_size;
+}
+
 std::string format_size(size_t bytes) {
     std::ostringstream oss;
     double size_gb = static_cast<double>(bytes) / BYTES_TO_GB;
@@ -59,45 +131,73 @@ std::string format_size(size_t bytes) {
     }
     return oss.str();
 }
-} // namespace
 
-void json_parser(const std::string& file_path) {
-    static simdjson::ondemand::parser parser;
+// The load itself; json_parser() wraps it with the phase summary
+void load_into_store(const std::string& file_path, const CancellationToken& token) {
     LoadingState& state = get_loading_state();
     JsonDataStore& data_store = get_json_data();
 
-    state.reset();
-    data_store.reset();
-    state.is_loading = true;
-    state.status_message = "Loading file...";
+    // Build into a fresh dataset; the current one stays browsable until publish()
+    auto dataset = std::make_shared<Dataset>();
+    simdjson::padded_string& json = dataset->raw_data;
 
-    simdjson::padded_string json;
+    auto stop_if_cancelled = [&]() {
+        if (!token.is_cancelled()) {
+            return false;
+        }
+        state.status_message = "Load cancelled";
+        state.is_loading = false;
+        return true;
+    };
 
     // Handle gzipped files
     if (ends_with(file_path, ".gz")) {
-        std::string decompressed = decompress_gzip(file_path);
+        std::string decompressed = decompress_gzip(file_path, token);
+        if (stop_if_cancelled()) {
+            return;
+        }
         if (decompressed.empty()) {
             state.is_loading = false;
             return;
         }
         json = simdjson::padded_string(decompressed);
     } else {
-        auto json_result = simdjson::padded_string::load(file_path);
-        if (json_result.error() != simdjson::SUCCESS) {
+        bool loaded = read_file(file_path, json, token);
+        if (stop_if_cancelled()) {
+            return;
+        }
+        if (!loaded) {
             state.error_message = "Error loading file";
             state.is_loading = false;
             return;
         }
-        json = std::move(json_result.value());
     }
 
     state.file_size_bytes = json.size();
     state.status_message = "File loaded: " + format_size(json.size());
+    request_ui_wake();
 
     // NDJSON streaming
     if (ends_with(file_path, ".ndjson") || ends_with(file_path, ".ndjson.gz")) {
+        // A sidecar written by `--headless index` replaces the indexing pass
+        state.begin_phase(LoadPhase::IndexPersist, 0);
+        if (load_index_file(file_path, json.size(), dataset->index)) {
+            size_t doc_count = dataset->index.size();
+            state.advance_phase(doc_count * sizeof(DocumentIndex));
+            data_store.publish(std::move(dataset));
+
+            state.documents_loaded = doc_count;
+            state.status_message =
+                "Complete! Total: " + std::to_string(doc_count) + " documents (saved index)";
+            state.is_loading = false;
+            state.is_complete = true;
+            return;
+        }
+
         state.status_message = "NDJSON detected, building index...";
+        state.begin_phase(LoadPhase::Index, json.size());
 
+        simdjson::ondemand::parser& parser = local_ondemand_parser(BATCH_SIZE);
         simdjson::ondemand::document_stream stream;
         auto stream_error = parser.iterate_many(json, BATCH_SIZE).get(stream);
         if (stream_error != simdjson::SUCCESS) {
@@ -110,6 +210,10 @@ void json_parser(const std::string& file_path) {
 
         // Use explicit iterator to access current_index() and source()
         for (auto iter = stream.begin(); iter != stream.end(); ++iter) {
+            if (stop_if_cancelled()) {
+                return;
+            }
+
             auto doc = *iter;
             if (doc.error() != simdjson::SUCCESS) {
                 state.error_message = "Error at document " + std::to_string(doc_count);
@@ -120,19 +224,21 @@ void json_parser(const std::string& file_path) {
             size_t offset = iter.current_index();
             std::string_view source = iter.source();
 
-            data_store.add_document_index(offset, source.size());
+            dataset->index.push_back({offset, source.size()});
+            state.advance_phase(offset + source.size());
 
             doc_count++;
             state.documents_loaded = doc_count;
 
             if (doc_count % PROGRESS_INTERVAL == 0) {
                 state.status_message = "Indexing " + std::to_string(doc_count) + " documents...";
+                trace_counter("documents_indexed", static_cast<double>(doc_count));
+                request_ui_wake();
             }
         }
 
-        // Move raw data to data store for on-demand access
-        data_store.set_raw_data(std::move(json));
-        data_store.set_complete();
+        // Swap the finished dataset in for on-demand access
+        data_store.publish(std::move(dataset));
 
         state.status_message = "Complete! Total: " + std::to_string(doc_count) + " documents";
         state.is_loading = false;
@@ -141,13 +247,12 @@ void json_parser(const std::string& file_path) {
     }
 
     // Regular single-document parsing
+    state.begin_phase(LoadPhase::Validate, json.size());
+    simdjson::ondemand::parser& parser = local_ondemand_parser(json.size());
     if (parser.capacity() < json.size()) {
-        auto alloc_error = parser.allocate(json.size());
-        if (alloc_error != simdjson::SUCCESS) {
-            state.error_message = "Error allocating parser";
-            state.is_loading = false;
-            return;
-        }
+        state.error_message = "Error allocating parser";
+        state.is_loading = false;
+        return;
     }
 
     auto doc = parser.iterate(json);
@@ -156,14 +261,105 @@ void json_parser(const std::string& file_path) {
         state.is_loading = false;
         return;
     }
+    if (stop_if_cancelled()) {
+        return;
+    }
+    state.advance_phase(json.size());
 
     // Store entire document as single index entry
-    data_store.add_document_index(0, json.size());
-    data_store.set_raw_data(std::move(json));
-    data_store.set_complete();
+    dataset->index.push_back({0, json.size()});
+    data_store.publish(std::move(dataset));
 
     state.documents_loaded = 1;
     state.status_message = "Parsed successfully";
     state.is_loading = false;
     state.is_complete = true;
 }
+} // namespace
+
+void json_parser(const std::string& file_path, const CancellationToken& token) {
+    LoadingState& state = get_loading_state();
+    state.reset();
+    state.is_loading = true;
+    state.status_message = "Loading file...";
+
+    auto start = std::chrono::steady_clock::now();
+    trace_begin("load");
+    load_into_store(file_path, token);
+    state.end_phase(); // A phase cut short by an error or cancel still counts
+    trace_end("load");
+    // A single-document parse sized the parser to the whole file
+    release_local_parsers();
+
+    if (!print_load_summary.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const char* outcome = "error";
+    if (state.is_complete) {
+        outcome = "complete";
+    } else if (token.is_cancelled()) {
+        outcome = "cancelled";
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%s\n", state.summary_json(file_path, outcome, seconds).c_str());
+}
+
+void set_load_summary_output(bool enabled) {
+    print_load_summary.store(enabled, std::memory_order_relaxed);
+}
+
+namespace {
+// Call with load_mutex held
+void submit_load() {
+    load_active = true;
+    load_started = false;
+    current_load = get_job_system().submit(JobPriority::Normal, [](const CancellationToken& token) {
+        std::string file_path;
+        {
+            std::lock_guard<std::mutex> lock(load_mutex);
+            load_started = true;
+            if (!requested_load) { // Cancelled while queued
+                load_active = false;
+                return;
+            }
+            file_path = std::move(*requested_load);
+            requested_load.reset();
+        }
+
+        json_parser(file_path, token);
+
+        std::lock_guard<std::mutex> lock(load_mutex);
+        if (requested_load) {
+            submit_load();
+        } else {
+            load_active = false;
+        }
+    });
+}
+} // namespace
+
+void start_json_load(const std::string& file_path) {
+    std::lock_guard<std::mutex> lock(load_mutex);
+    requested_load = file_path;
+    if (!load_active) {
+        submit_load();
+    } else if (load_started) {
+        // Stop the running load; it submits this one when it returns. A queued
+        // job is left alone: it picks up the new file when it starts.
+        current_load.cancel();
+    }
+}
+
+void cancel_json_load() {
+    std::lock_guard<std::mutex> lock(load_mutex);
+    requested_load.reset();
+    if (load_started) {
+        current_load.cancel();
+    }
+}
+
+bool json_load_in_progress() {
+    std::lock_guard<std::mutex> lock(load_mutex);
+    return load_active;
+}
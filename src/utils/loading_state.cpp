@@ -1,6 +1,123 @@
 #include "utils/loading_state.hpp"
 
-LoadingState &get_loading_state() {
-  static LoadingState state;
-  return state;
+#include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
+#include "utils/memory_stats.hpp"
+#include "utils/trace.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+constexpr std::array<const char*, LOAD_PHASE_COUNT> PHASE_NAMES = {
+    "read", "decompress", "index", "validate", "index_persist"};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void append_number(std::string& out, const char* format, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    out += buffer;
+}
+} // namespace
+
+// The dataset being built is not in the store until published: its raw buffer
+// (once read) plus the index entries so far
+REGISTER_MEMORY_REPORTER(load_in_progress, [] {
+    LoadingState& state = get_loading_state();
+    if (!state.is_loading) {
+        return size_t{0};
+    }
+    return state.file_size_bytes.load() + state.documents_loaded.load() * sizeof(DocumentIndex);
+});
+
+const char* load_phase_name(LoadPhase phase) {
+    auto slot = static_cast<size_t>(phase);
+    return slot < LOAD_PHASE_COUNT ? PHASE_NAMES[slot] : "none";
+}
+
+void LoadingState::begin_phase(LoadPhase phase, size_t total_bytes) {
+    end_phase();
+    phase_bytes_done.store(0, std::memory_order_relaxed);
+    phase_bytes_total.store(total_bytes, std::memory_order_relaxed);
+    phase_start_ns.store(now_ns(), std::memory_order_relaxed);
+    current_phase.store(phase, std::memory_order_release);
+    trace_begin(load_phase_name(phase));
+}
+
+void LoadingState::end_phase() {
+    LoadPhase phase = current_phase.exchange(LoadPhase::Count, std::memory_order_acq_rel);
+    if (phase == LoadPhase::Count) {
+        return;
+    }
+    trace_end(load_phase_name(phase));
+    // Only the loader writes phase totals, so load-then-store is enough
+    LoadPhaseStats& stats = phases[static_cast<size_t>(phase)];
+    double elapsed = static_cast<double>(now_ns() - phase_start_ns.load()) * 1e-9;
+    stats.seconds = stats.seconds.load() + elapsed;
+    stats.bytes = stats.bytes.load() + phase_bytes_done.load(std::memory_order_relaxed);
+}
+
+LoadProgress LoadingState::progress() const {
+    LoadProgress progress;
+    progress.phase = current_phase.load(std::memory_order_acquire);
+    if (progress.phase == LoadPhase::Count) {
+        return progress;
+    }
+    progress.bytes_done = phase_bytes_done.load(std::memory_order_relaxed);
+    progress.bytes_total = phase_bytes_total.load(std::memory_order_relaxed);
+
+    double elapsed = static_cast<double>(now_ns() - phase_start_ns.load()) * 1e-9;
+    if (elapsed > 0.0) {
+        progress.bytes_per_second = static_cast<double>(progress.bytes_done) / elapsed;
+    }
+    if (progress.bytes_per_second > 0.0 && progress.bytes_total >= progress.bytes_done) {
+        progress.eta_seconds = static_cast<double>(progress.bytes_total - progress.bytes_done) /
+                               progress.bytes_per_second;
+    }
+    return progress;
+}
+
+std::string LoadingState::summary_json(std::string_view file_path, std::string_view outcome,
+                                       double total_seconds) const {
+    std::string out = "{\"file\":";
+    append_json_string(out, file_path);
+    out += ",\"outcome\":";
+    append_json_string(out, outcome);
+    out += ",\"documents\":" + std::to_string(documents_loaded.load());
+    out += ",\"raw_bytes\":" + std::to_string(file_size_bytes.load());
+    out += ",\"seconds\":";
+    append_number(out, "%.6f", total_seconds);
+    out += ",\"phases\":{";
+
+    bool first = true;
+    for (size_t slot = 0; slot < LOAD_PHASE_COUNT; slot++) {
+        double seconds = phases[slot].seconds.load();
+        size_t bytes = phases[slot].bytes.load();
+        if (seconds <= 0.0) {
+            continue; // Did not run
+        }
+        out += first ? "\"" : ",\"";
+        first = false;
+        out += PHASE_NAMES[slot];
+        out += "\":{\"seconds\":";
+        append_number(out, "%.6f", seconds);
+        out += ",\"bytes\":" + std::to_string(bytes);
+        out += ",\"mb_per_s\":";
+        append_number(out, "%.1f", static_cast<double>(bytes) / BYTES_PER_MB / seconds);
+        out += '}';
+    }
+    out += "}}";
+    return out;
+}
+
+LoadingState& get_loading_state() {
+    static LoadingState state;
+    return state;
 }
@@ -0,0 +1,80 @@
+#include "utils/memory_stats.hpp"
+
+#include <mutex>
+
+#ifdef __linux__
+    #include <fstream>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+struct Reporter {
+    const char* name;
+    std::function<size_t()> report;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Reporter> reporters;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+void read_process_memory(MemoryReport& report) {
+#ifdef __linux__
+    // statm: total program size, then resident pages
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+        report.rss_bytes = resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        report.peak_rss_bytes = static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes
+    }
+#else
+    (void)report;
+#endif
+}
+} // namespace
+
+void register_memory_reporter(const char* name, std::function<size_t()> reporter) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.reporters.push_back({name, std::move(reporter)});
+}
+
+MemoryReport memory_report() {
+    MemoryReport report;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        report.items.reserve(reg.reporters.size());
+        for (const Reporter& reporter : reg.reporters) {
+            size_t bytes = reporter.report();
+            report.items.push_back({reporter.name, bytes});
+            report.accounted_bytes += bytes;
+        }
+    }
+    read_process_memory(report);
+    return report;
+}
+
+std::string memory_report_json(const MemoryReport& report) {
+    std::string out = "{\"rss_bytes\":" + std::to_string(report.rss_bytes);
+    out += ",\"peak_rss_bytes\":" + std::to_string(report.peak_rss_bytes);
+    out += ",\"accounted_bytes\":" + std::to_string(report.accounted_bytes);
+    out += ",\"items\":{";
+    for (size_t i = 0; i < report.items.size(); i++) {
+        out += i == 0 ? "\"" : ",\"";
+        out += report.items[i].name; // Identifier-like: no escaping
+        out += "\":" + std::to_string(report.items[i].bytes);
+    }
+    out += "}}";
+    return out;
+}
@@ -0,0 +1,72 @@
+#include "utils/parallel_search.hpp"
+
+#include "utils/trace.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+ParallelSearch::ParallelSearch(SearchQuery query, const DatasetSnapshot& snapshot,
+                               JobPriority priority) {
+    auto shared_query = std::make_shared<const SearchQuery>(std::move(query));
+    size_t document_count = snapshot.document_count();
+
+    for (size_t begin = 0; begin < document_count; begin += CHUNK_DOCUMENTS) {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->begin = begin;
+        chunk->end = std::min(begin + CHUNK_DOCUMENTS, document_count);
+        chunks_.push_back(chunk);
+    }
+
+    // Submit after the chunk list is complete; jobs only touch their own chunk
+    for (const auto& chunk : chunks_) {
+        chunk->handle = get_job_system().submit(
+            priority,
+            [chunk, shared_query, snapshot](const CancellationToken& token) {
+                TRACE_SCOPE("search_chunk");
+                std::pmr::vector<uint64_t> doc_offsets;
+                for (size_t i = chunk->begin; i < chunk->end && !token.is_cancelled(); i++) {
+                    std::string_view doc = snapshot.document(i);
+                    doc_offsets.clear();
+                    if (find_matches(*shared_query, doc, doc_offsets) > 0) {
+                        chunk->results.matches.add(i);
+                        chunk->results.offsets.add_document(i, doc_offsets);
+                    }
+                }
+            },
+            token_);
+    }
+}
+
+ParallelSearch::~ParallelSearch() {
+    cancel();
+}
+
+void ParallelSearch::cancel() {
+    token_.cancel();
+}
+
+void ParallelSearch::wait() const {
+    for (const auto& chunk : chunks_) {
+        chunk->handle.wait();
+    }
+}
+
+size_t ParallelSearch::collect(SearchResults& results, size_t max_chunks) {
+    size_t merged = 0;
+    while (merged < max_chunks && next_chunk_ < chunks_.size() &&
+           chunks_[next_chunk_]->handle.is_done()) {
+        Chunk& chunk = *chunks_[next_chunk_];
+        results.matches.append(chunk.results.matches);
+        results.offsets.append(chunk.results.offsets);
+        chunk.results.clear();
+        next_chunk_++;
+        merged++;
+    }
+    return merged;
+}
+
+size_t ParallelSearch::documents_scanned() const {
+    return next_chunk_ == 0 ? 0 : chunks_[next_chunk_ - 1]->end;
+}
@@ -0,0 +1,101 @@
+#include "utils/parser_pool.hpp"
+
+#include "utils/memory_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+constexpr size_t MIN_RETAINED_CAPACITY = 1024ULL * 1024ULL;        // Never shrink below 1MB
+constexpr size_t MAX_RETAINED_CAPACITY = 16ULL * 1024ULL * 1024ULL; // Kept past a trim at most
+constexpr std::chrono::seconds SHRINK_DELAY{5};
+
+// Approximate buffer bytes per byte of capacity (simdjson 3.x): 4 for
+// structural indexes, 5/3 for strings, plus 8 for the dom tape
+constexpr size_t DOM_BYTES_PER_CAPACITY = 14;
+constexpr size_t ONDEMAND_BYTES_PER_CAPACITY = 6;
+
+// Estimated buffer bytes of every thread's parsers
+std::atomic<size_t> parser_bytes{0};
+
+template <typename Parser, size_t BYTES_PER_CAPACITY>
+class PooledParser {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PooledParser() = default;
+    PooledParser(const PooledParser&) = delete;
+    PooledParser& operator=(const PooledParser&) = delete;
+    ~PooledParser() { parser_bytes -= parser_.capacity() * BYTES_PER_CAPACITY; }
+
+    Parser& acquire(size_t document_size) {
+        last_document_ = document_size;
+        Clock::time_point now = Clock::now();
+        size_t target = std::max(document_size, MIN_RETAINED_CAPACITY);
+        if (parser_.capacity() <= target * 2) {
+            last_needed_ = now; // The capacity is still earning its keep
+        } else if (now - last_needed_ >= SHRINK_DELAY) {
+            reserve(target);
+            last_needed_ = now;
+        }
+
+        // Grow ahead of parsing so the parse itself never reallocates
+        if (parser_.capacity() < document_size) {
+            reserve(document_size);
+        }
+        return parser_;
+    }
+
+    // Shrinks to the last document's size (at most MAX_RETAINED_CAPACITY) if the
+    // capacity is oversized and, unless `immediate`, has gone unused for SHRINK_DELAY
+    void trim(bool immediate) {
+        size_t keep = std::clamp(last_document_, MIN_RETAINED_CAPACITY, MAX_RETAINED_CAPACITY);
+        size_t capacity = parser_.capacity();
+        if (capacity <= keep * 2 && capacity <= MAX_RETAINED_CAPACITY) {
+            return;
+        }
+        Clock::time_point now = Clock::now();
+        if (immediate || now - last_needed_ >= SHRINK_DELAY) {
+            reserve(keep);
+            last_needed_ = now;
+        }
+    }
+
+private:
+    // On failure the old buffers stay; callers that need the capacity check it
+    void reserve(size_t capacity) {
+        size_t old_capacity = parser_.capacity();
+        [[maybe_unused]] simdjson::error_code error = parser_.allocate(capacity);
+        parser_bytes += parser_.capacity() * BYTES_PER_CAPACITY;
+        parser_bytes -= old_capacity * BYTES_PER_CAPACITY;
+    }
+
+    Parser parser_;
+    size_t last_document_ = 0;
+    Clock::time_point last_needed_ = Clock::now();
+};
+
+thread_local PooledParser<simdjson::dom::parser, DOM_BYTES_PER_CAPACITY> dom_pool;
+thread_local PooledParser<simdjson::ondemand::parser, ONDEMAND_BYTES_PER_CAPACITY> ondemand_pool;
+} // namespace
+
+REGISTER_MEMORY_REPORTER(parser_buffers, [] { return parser_bytes.load(); });
+
+simdjson::dom::parser& local_dom_parser(size_t document_size) {
+    return dom_pool.acquire(document_size);
+}
+
+simdjson::ondemand::parser& local_ondemand_parser(size_t document_size) {
+    return ondemand_pool.acquire(document_size);
+}
+
+void trim_local_parsers() {
+    dom_pool.trim(false);
+    ondemand_pool.trim(false);
+}
+
+void release_local_parsers() {
+    dom_pool.trim(true);
+    ondemand_pool.trim(true);
+}
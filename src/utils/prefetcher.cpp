@@ -0,0 +1,152 @@
+#include "utils/prefetcher.hpp"
+
+#include "utils/document_formatter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using ByteRange = std::pair<const char*, const char*>;
+
+// Asks the kernel to start reading [begin, end) back in if it was paged out
+void advise_will_need(const ByteRange& range) {
+#if defined(__unix__) || defined(__APPLE__)
+    static const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t first_page = reinterpret_cast<uintptr_t>(range.first) & ~(page_size - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(range.second);
+    madvise(reinterpret_cast<void*>(first_page), end - first_page, MADV_WILLNEED);
+#else
+    (void)range;
+#endif
+}
+} // namespace
+
+Prefetcher& Prefetcher::instance() {
+    static Prefetcher prefetcher;
+    return prefetcher;
+}
+
+Prefetcher& get_prefetcher() {
+    return Prefetcher::instance();
+}
+
+void Prefetcher::update(const DatasetSnapshot& snapshot, const ResultSet& rows,
+                        uint64_t rows_version, size_t first_visible, size_t last_visible,
+                        IsExpandedFn is_expanded) {
+    uint64_t row_count = rows.size();
+    if (snapshot.generation() != generation_ || &rows != rows_ || rows_version != rows_version_ ||
+        row_count != row_count_) {
+        // Different rows: ranks no longer line up with what was issued
+        cancel();
+        generation_ = snapshot.generation();
+        rows_ = &rows;
+        rows_version_ = rows_version;
+        row_count_ = row_count;
+        last_first_visible_ = first_visible;
+        velocity_ = 0.0;
+        return;
+    }
+
+    size_t screen = std::max<size_t>(last_visible - first_visible, 1);
+    size_t travel = first_visible > last_first_visible_ ? first_visible - last_first_visible_
+                                                        : last_first_visible_ - first_visible;
+    if (travel > screen * REPOSITION_SCREENS) {
+        // A jump, not a scroll: start over from the new position
+        cancel();
+        last_first_visible_ = first_visible;
+        velocity_ = 0.0;
+        return;
+    }
+
+    double sample = static_cast<double>(first_visible) - static_cast<double>(last_first_visible_);
+    last_first_visible_ = first_visible;
+    velocity_ = VELOCITY_SMOOTHING * sample + (1.0 - VELOCITY_SMOOTHING) * velocity_;
+
+    int direction = 0;
+    if (velocity_ >= MIN_VELOCITY) {
+        direction = 1;
+    } else if (velocity_ <= -MIN_VELOCITY) {
+        direction = -1;
+    }
+    if (direction == 0) {
+        return; // Idle: let queued work finish, issue nothing new
+    }
+    if (direction != direction_) {
+        cancel();
+        direction_ = direction;
+        prefetched_begin_ = first_visible;
+        prefetched_end_ = last_visible;
+    }
+
+    size_t lookahead = std::min(
+        screen * SCREENS_AHEAD + static_cast<size_t>(std::abs(velocity_) * LOOKAHEAD_FRAMES),
+        MAX_PREFETCH_ROWS);
+    if (direction > 0) {
+        size_t begin = std::max(last_visible, prefetched_end_);
+        size_t end = std::min<size_t>(last_visible + lookahead, row_count);
+        if (begin < end) {
+            prefetch_range(snapshot, rows, begin, end, is_expanded);
+            prefetched_end_ = end;
+        }
+    } else {
+        size_t begin = first_visible > lookahead ? first_visible - lookahead : 0;
+        size_t end = std::min(first_visible, prefetched_begin_);
+        if (begin < end) {
+            prefetch_range(snapshot, rows, begin, end, is_expanded);
+            prefetched_begin_ = begin;
+        }
+    }
+}
+
+void Prefetcher::prefetch_range(const DatasetSnapshot& snapshot, const ResultSet& rows,
+                                size_t begin, size_t end, IsExpandedFn is_expanded) {
+    DocumentFormatter& formatter = get_document_formatter();
+
+    // Coalesce the rows' raw bytes into runs; filtered-out documents between
+    // rows are skipped unless the gap is within a page
+    std::vector<ByteRange> runs;
+    auto iter = rows.iterator_at(begin);
+    for (size_t rank = begin; rank < end; rank++, ++iter) {
+        size_t doc_index = *iter;
+        if (is_expanded(doc_index)) {
+            formatter.prefetch(snapshot, doc_index);
+        }
+
+        std::string_view raw = snapshot.document(doc_index);
+        const char* raw_end = raw.data() + raw.size();
+        if (!runs.empty() && raw.data() >= runs.back().second &&
+            raw.data() - runs.back().second <= static_cast<std::ptrdiff_t>(ADVISE_GAP)) {
+            runs.back().second = raw_end;
+        } else {
+            runs.emplace_back(raw.data(), raw_end);
+        }
+    }
+
+    get_job_system().submit(
+        JobPriority::Low,
+        [snapshot, runs = std::move(runs)](const CancellationToken& token) {
+            // The snapshot keeps the raw buffer alive while the runs are advised
+            for (const ByteRange& run : runs) {
+                if (token.is_cancelled()) {
+                    return;
+                }
+                advise_will_need(run);
+            }
+        },
+        token_);
+}
+
+void Prefetcher::cancel() {
+    token_.cancel();
+    token_ = CancellationToken();
+    direction_ = 0;
+    get_document_formatter().cancel_prefetch();
+}
@@ -0,0 +1,77 @@
+#include "utils/query_cache.hpp"
+
+#include "utils/memory_stats.hpp"
+
+#include <utility>
+
+REGISTER_MEMORY_REPORTER(query_cache, [] { return get_query_cache().memory_bytes(); });
+
+QueryCache& QueryCache::instance() {
+    static QueryCache cache;
+    return cache;
+}
+
+QueryCache& get_query_cache() {
+    return QueryCache::instance();
+}
+
+std::string QueryCache::make_key(const SearchQuery& query) {
+    std::string key(1, static_cast<char>(query.kind));
+    key += query.text;
+    return key;
+}
+
+void QueryCache::drop_stale(size_t generation) {
+    if (generation != generation_) {
+        clear();
+        generation_ = generation;
+    }
+}
+
+std::optional<SearchResults> QueryCache::find(const SearchQuery& query, size_t generation) {
+    drop_stale(generation);
+
+    auto lookup_iter = lookup_.find(make_key(query));
+    if (lookup_iter == lookup_.end()) {
+        return std::nullopt;
+    }
+
+    // Move to front (most recently used)
+    entries_.splice(entries_.begin(), entries_, lookup_iter->second);
+    return lookup_iter->second->results;
+}
+
+void QueryCache::insert(const SearchQuery& query, size_t generation,
+                        const SearchResults& results) {
+    drop_stale(generation);
+
+    size_t bytes = results.memory_bytes();
+    if (bytes > MEMORY_BUDGET) {
+        return;
+    }
+
+    std::string key = make_key(query);
+    auto lookup_iter = lookup_.find(key);
+    if (lookup_iter != lookup_.end()) {
+        bytes_used_ -= lookup_iter->second->bytes;
+        entries_.erase(lookup_iter->second);
+        lookup_.erase(lookup_iter);
+    }
+
+    // Evict least recently used until the new entry fits
+    while (!entries_.empty() && bytes_used_ + bytes > MEMORY_BUDGET) {
+        bytes_used_ -= entries_.back().bytes;
+        lookup_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+
+    entries_.push_front({key, results, bytes});
+    lookup_[std::move(key)] = entries_.begin();
+    bytes_used_ += bytes;
+}
+
+void QueryCache::clear() {
+    entries_.clear();
+    lookup_.clear();
+    bytes_used_ = 0;
+}
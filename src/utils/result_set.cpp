@@ -0,0 +1,495 @@
+#include "utils/result_set.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+namespace {
+uint64_t low_mask(uint32_t bit) {
+    return bit == 0 ? 0 : (~uint64_t{0} >> (64 - bit));
+}
+
+// Position of the rank-th set bit in a word
+uint32_t select_in_word(uint64_t word, uint32_t rank) {
+    for (uint32_t i = 0; i < rank; i++) {
+        word &= word - 1;
+    }
+    return static_cast<uint32_t>(std::countr_zero(word));
+}
+} // namespace
+
+// === Chunk ===
+
+bool ResultSet::Chunk::contains(uint16_t low) const {
+    switch (kind) {
+    case Kind::Range:
+        return low >= range_start && static_cast<uint32_t>(low - range_start) < cardinality;
+    case Kind::Array:
+        return std::binary_search(array.begin(), array.end(), low);
+    case Kind::Bitmap:
+        return ((bitmap[low / 64] >> (low % 64)) & 1U) != 0;
+    }
+    return false;
+}
+
+uint16_t ResultSet::Chunk::select(uint32_t rank) const {
+    switch (kind) {
+    case Kind::Range:
+        return static_cast<uint16_t>(range_start + rank);
+    case Kind::Array:
+        return array[rank];
+    case Kind::Bitmap:
+        for (uint32_t word = 0; word < BITMAP_WORDS; word++) {
+            auto count = static_cast<uint32_t>(std::popcount(bitmap[word]));
+            if (rank < count) {
+                return static_cast<uint16_t>(word * 64 + select_in_word(bitmap[word], rank));
+            }
+            rank -= count;
+        }
+        break;
+    }
+    return 0;
+}
+
+void ResultSet::Chunk::to_bitmap(std::vector<uint64_t>& words) const {
+    words.assign(BITMAP_WORDS, 0);
+    switch (kind) {
+    case Kind::Range: {
+        uint32_t begin = range_start;
+        uint32_t end = range_start + cardinality;
+        for (uint32_t word = begin / 64; word <= (end - 1) / 64; word++) {
+            uint32_t lo = std::max(begin, word * 64) - word * 64;
+            uint32_t hi = std::min(end, (word + 1) * 64) - word * 64;
+            words[word] = low_mask(hi) & ~low_mask(lo);
+        }
+        break;
+    }
+    case Kind::Array:
+        for (uint16_t low : array) {
+            words[low / 64] |= uint64_t{1} << (low % 64);
+        }
+        break;
+    case Kind::Bitmap:
+        words = bitmap;
+        break;
+    }
+}
+
+void ResultSet::Chunk::insert(uint16_t low) {
+    if (contains(low)) {
+        return;
+    }
+
+    // Extending a range at its end keeps it a range (the common "append" case)
+    if (kind == Kind::Range && low == range_start + cardinality) {
+        cardinality++;
+        return;
+    }
+
+    if (kind == Kind::Range) {
+        std::vector<uint64_t> words;
+        to_bitmap(words);
+        words[low / 64] |= uint64_t{1} << (low % 64);
+        normalize_from_bitmap(words, *this);
+        return;
+    }
+
+    if (kind == Kind::Array) {
+        array.insert(std::upper_bound(array.begin(), array.end(), low), low);
+        cardinality++;
+        if (cardinality > ARRAY_MAX) {
+            std::vector<uint64_t> words;
+            to_bitmap(words);
+            kind = Kind::Bitmap;
+            bitmap = std::move(words);
+            array = {};
+        }
+        return;
+    }
+
+    bitmap[low / 64] |= uint64_t{1} << (low % 64);
+    cardinality++;
+}
+
+// === ResultSet ===
+
+ResultSet::Chunk ResultSet::make_range_chunk(uint64_t key, uint32_t start, uint32_t count) {
+    Chunk chunk;
+    chunk.key = key;
+    chunk.kind = Kind::Range;
+    chunk.range_start = static_cast<uint16_t>(start);
+    chunk.cardinality = count;
+    return chunk;
+}
+
+// Picks the smallest representation for the bits in `words`
+void ResultSet::normalize_from_bitmap(std::vector<uint64_t>& words, Chunk& out) {
+    uint32_t cardinality = 0;
+    for (uint64_t word : words) {
+        cardinality += static_cast<uint32_t>(std::popcount(word));
+    }
+    out.cardinality = cardinality;
+    out.array = {};
+    out.bitmap = {};
+    if (cardinality == 0) {
+        return;
+    }
+
+    uint32_t first = 0;
+    while (words[first / 64] == 0) {
+        first += 64;
+    }
+    first += static_cast<uint32_t>(std::countr_zero(words[first / 64]));
+
+    uint32_t last_word = BITMAP_WORDS - 1;
+    while (words[last_word] == 0) {
+        last_word--;
+    }
+    uint32_t last = last_word * 64 + 63 - static_cast<uint32_t>(std::countl_zero(words[last_word]));
+
+    if (last - first + 1 == cardinality) {
+        out.kind = Kind::Range;
+        out.range_start = static_cast<uint16_t>(first);
+        return;
+    }
+
+    if (cardinality <= ARRAY_MAX) {
+        out.kind = Kind::Array;
+        out.array.reserve(cardinality);
+        for (uint32_t word = first / 64; word <= last_word; word++) {
+            uint64_t bits = words[word];
+            while (bits != 0) {
+                auto bit = static_cast<uint32_t>(std::countr_zero(bits));
+                out.array.push_back(static_cast<uint16_t>(word * 64 + bit));
+                bits &= bits - 1;
+            }
+        }
+        return;
+    }
+
+    out.kind = Kind::Bitmap;
+    out.bitmap = std::move(words);
+}
+
+ResultSet ResultSet::all(uint64_t count) {
+    return range(0, count);
+}
+
+ResultSet ResultSet::range(uint64_t begin, uint64_t end) {
+    ResultSet set;
+    while (begin < end) {
+        uint64_t key = begin >> CHUNK_BITS;
+        uint64_t chunk_end = std::min(end, (key + 1) << CHUNK_BITS);
+        auto start = static_cast<uint32_t>(begin & (CHUNK_SIZE - 1));
+        set.push_chunk(make_range_chunk(key, start, static_cast<uint32_t>(chunk_end - begin)));
+        begin = chunk_end;
+    }
+    return set;
+}
+
+void ResultSet::push_chunk(Chunk&& chunk) {
+    if (chunk.cardinality == 0) {
+        return;
+    }
+    chunk.rank_base = chunks_.empty() ? 0 : chunks_.back().rank_base + chunks_.back().cardinality;
+    chunks_.push_back(std::move(chunk));
+}
+
+void ResultSet::add(uint64_t index) {
+    uint64_t key = index >> CHUNK_BITS;
+    auto low = static_cast<uint16_t>(index & (CHUNK_SIZE - 1));
+
+    // Fast path: append to (or after) the last chunk
+    if (chunks_.empty() || chunks_.back().key < key) {
+        push_chunk(make_range_chunk(key, low, 1));
+        return;
+    }
+    if (chunks_.back().key == key) {
+        chunks_.back().insert(low);
+        return;
+    }
+
+    // Slow path: out-of-order insert, ranks of later chunks shift
+    auto chunk_iter =
+        std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                         [](const Chunk& chunk, uint64_t k) { return chunk.key < k; });
+    if (chunk_iter->key != key) {
+        Chunk chunk = make_range_chunk(key, low, 1);
+        chunk.rank_base = chunk_iter->rank_base;
+        chunk_iter = chunks_.insert(chunk_iter, std::move(chunk));
+    } else {
+        uint32_t before = chunk_iter->cardinality;
+        chunk_iter->insert(low);
+        if (chunk_iter->cardinality == before) {
+            return;
+        }
+    }
+    for (auto iter = std::next(chunk_iter); iter != chunks_.end(); ++iter) {
+        iter->rank_base++;
+    }
+}
+
+void ResultSet::append(const ResultSet& later) {
+    for (const Chunk& chunk : later.chunks_) {
+        if (!chunks_.empty() && chunks_.back().key == chunk.key) {
+            // Both sides touch the same 2^16 block: merge the boundary chunk
+            Chunk merged;
+            combine_chunks(chunks_.back(), chunk, Op::Or, merged);
+            merged.rank_base = chunks_.back().rank_base;
+            chunks_.back() = std::move(merged);
+            continue;
+        }
+        Chunk copy = chunk;
+        push_chunk(std::move(copy));
+    }
+}
+
+bool ResultSet::contains(uint64_t index) const {
+    uint64_t key = index >> CHUNK_BITS;
+    auto chunk_iter =
+        std::lower_bound(chunks_.begin(), chunks_.end(), key,
+                         [](const Chunk& chunk, uint64_t k) { return chunk.key < k; });
+    if (chunk_iter == chunks_.end() || chunk_iter->key != key) {
+        return false;
+    }
+    return chunk_iter->contains(static_cast<uint16_t>(index & (CHUNK_SIZE - 1)));
+}
+
+void ResultSet::clear() {
+    chunks_.clear();
+}
+
+uint64_t ResultSet::size() const {
+    return chunks_.empty() ? 0 : chunks_.back().rank_base + chunks_.back().cardinality;
+}
+
+uint64_t ResultSet::select(uint64_t rank) const {
+    auto chunk_iter =
+        std::upper_bound(chunks_.begin(), chunks_.end(), rank,
+                         [](uint64_t r, const Chunk& chunk) { return r < chunk.rank_base; });
+    const Chunk& chunk = *std::prev(chunk_iter);
+    return (chunk.key << CHUNK_BITS) | chunk.select(static_cast<uint32_t>(rank - chunk.rank_base));
+}
+
+size_t ResultSet::memory_bytes() const {
+    size_t bytes = chunks_.capacity() * sizeof(Chunk);
+    for (const Chunk& chunk : chunks_) {
+        bytes += chunk.array.capacity() * sizeof(uint16_t);
+        bytes += chunk.bitmap.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+bool ResultSet::operator==(const ResultSet& other) const {
+    if (size() != other.size()) {
+        return false;
+    }
+    return (*this - other).empty();
+}
+
+// === Set algebra ===
+
+bool ResultSet::combine_chunks(const Chunk& lhs, const Chunk& rhs, Op op, Chunk& out) {
+    out.key = lhs.key;
+
+    // Range/range intersection stays a range
+    if (op == Op::And && lhs.kind == Kind::Range && rhs.kind == Kind::Range) {
+        uint32_t begin = std::max<uint32_t>(lhs.range_start, rhs.range_start);
+        uint32_t end = std::min<uint32_t>(lhs.range_start + lhs.cardinality,
+                                          rhs.range_start + rhs.cardinality);
+        out = make_range_chunk(lhs.key, begin, end > begin ? end - begin : 0);
+        return out.cardinality > 0;
+    }
+
+    // Sparse intersection: probe the array against the other chunk
+    if (op == Op::And && (lhs.kind == Kind::Array || rhs.kind == Kind::Array)) {
+        const Chunk& sparse = lhs.kind == Kind::Array ? lhs : rhs;
+        const Chunk& other = lhs.kind == Kind::Array ? rhs : lhs;
+        out.kind = Kind::Array;
+        out.array.clear();
+        for (uint16_t low : sparse.array) {
+            if (other.contains(low)) {
+                out.array.push_back(low);
+            }
+        }
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+        return out.cardinality > 0;
+    }
+
+    if (op == Op::AndNot && lhs.kind == Kind::Array) {
+        out.kind = Kind::Array;
+        out.array.clear();
+        for (uint16_t low : lhs.array) {
+            if (!rhs.contains(low)) {
+                out.array.push_back(low);
+            }
+        }
+        out.cardinality = static_cast<uint32_t>(out.array.size());
+        return out.cardinality > 0;
+    }
+
+    // General case: word-wise on bitmaps, then re-compress
+    std::vector<uint64_t> lhs_words;
+    std::vector<uint64_t> rhs_words;
+    lhs.to_bitmap(lhs_words);
+    rhs.to_bitmap(rhs_words);
+    for (uint32_t word = 0; word < BITMAP_WORDS; word++) {
+        switch (op) {
+        case Op::And:
+            lhs_words[word] &= rhs_words[word];
+            break;
+        case Op::Or:
+            lhs_words[word] |= rhs_words[word];
+            break;
+        case Op::AndNot:
+            lhs_words[word] &= ~rhs_words[word];
+            break;
+        }
+    }
+    normalize_from_bitmap(lhs_words, out);
+    return out.cardinality > 0;
+}
+
+ResultSet ResultSet::combine(const ResultSet& lhs, const ResultSet& rhs, Op op) {
+    ResultSet result;
+    size_t lhs_pos = 0;
+    size_t rhs_pos = 0;
+
+    while (lhs_pos < lhs.chunks_.size() || rhs_pos < rhs.chunks_.size()) {
+        bool has_lhs = lhs_pos < lhs.chunks_.size();
+        bool has_rhs = rhs_pos < rhs.chunks_.size();
+
+        if (has_lhs && (!has_rhs || lhs.chunks_[lhs_pos].key < rhs.chunks_[rhs_pos].key)) {
+            // Chunk only on the left
+            if (op != Op::And) {
+                Chunk chunk = lhs.chunks_[lhs_pos];
+                result.push_chunk(std::move(chunk));
+            }
+            lhs_pos++;
+        } else if (has_rhs && (!has_lhs || rhs.chunks_[rhs_pos].key < lhs.chunks_[lhs_pos].key)) {
+            // Chunk only on the right
+            if (op == Op::Or) {
+                Chunk chunk = rhs.chunks_[rhs_pos];
+                result.push_chunk(std::move(chunk));
+            }
+            rhs_pos++;
+        } else {
+            Chunk chunk;
+            if (combine_chunks(lhs.chunks_[lhs_pos], rhs.chunks_[rhs_pos], op, chunk)) {
+                result.push_chunk(std::move(chunk));
+            }
+            lhs_pos++;
+            rhs_pos++;
+        }
+    }
+    return result;
+}
+
+ResultSet ResultSet::operator&(const ResultSet& other) const {
+    return combine(*this, other, Op::And);
+}
+
+ResultSet ResultSet::operator|(const ResultSet& other) const {
+    return combine(*this, other, Op::Or);
+}
+
+ResultSet ResultSet::operator-(const ResultSet& other) const {
+    return combine(*this, other, Op::AndNot);
+}
+
+ResultSet ResultSet::complement(uint64_t universe) const {
+    return combine(all(universe), *this, Op::AndNot);
+}
+
+// === Iteration ===
+
+ResultSet::Iterator ResultSet::begin() const {
+    return {this, 0, 0};
+}
+
+ResultSet::Iterator ResultSet::end() const {
+    return {this, chunks_.size(), 0};
+}
+
+ResultSet::Iterator ResultSet::iterator_at(uint64_t rank) const {
+    if (rank >= size()) {
+        return end();
+    }
+    auto chunk_iter =
+        std::upper_bound(chunks_.begin(), chunks_.end(), rank,
+                         [](uint64_t r, const Chunk& chunk) { return r < chunk.rank_base; });
+    auto chunk_index = static_cast<size_t>(std::distance(chunks_.begin(), chunk_iter) - 1);
+    const Chunk& chunk = chunks_[chunk_index];
+    auto chunk_rank = static_cast<uint32_t>(rank - chunk.rank_base);
+
+    if (chunk.kind != Kind::Bitmap) {
+        return {this, chunk_index, chunk_rank};
+    }
+
+    // Bitmap: find the word holding the member, then drop the bits below it
+    Iterator iter(this, chunk_index, 0);
+    uint32_t word = 0;
+    for (; word < BITMAP_WORDS; word++) {
+        auto count = static_cast<uint32_t>(std::popcount(chunk.bitmap[word]));
+        if (chunk_rank < count) {
+            break;
+        }
+        chunk_rank -= count;
+    }
+    iter.pos_ = word;
+    iter.bits_ = chunk.bitmap[word] & ~low_mask(select_in_word(chunk.bitmap[word], chunk_rank));
+    auto bit = static_cast<uint32_t>(std::countr_zero(iter.bits_));
+    iter.value_ = (chunk.key << CHUNK_BITS) | (word * 64 + bit);
+    return iter;
+}
+
+ResultSet::Iterator::Iterator(const ResultSet* set, size_t chunk, uint32_t pos)
+    : set_(set), chunk_(chunk), pos_(pos) {
+    load();
+}
+
+// Resolves value_ for the current position, skipping to the next chunk when exhausted
+void ResultSet::Iterator::load() {
+    while (chunk_ < set_->chunks_.size()) {
+        const Chunk& chunk = set_->chunks_[chunk_];
+        uint64_t base = chunk.key << CHUNK_BITS;
+
+        if (chunk.kind == Kind::Bitmap) {
+            if (bits_ == 0) {
+                while (pos_ < BITMAP_WORDS && chunk.bitmap[pos_] == 0) {
+                    pos_++;
+                }
+                if (pos_ < BITMAP_WORDS) {
+                    bits_ = chunk.bitmap[pos_];
+                }
+            }
+            if (bits_ != 0) {
+                value_ = base | (pos_ * 64 + static_cast<uint32_t>(std::countr_zero(bits_)));
+                return;
+            }
+        } else if (pos_ < chunk.cardinality) {
+            value_ = base |
+                     (chunk.kind == Kind::Range ? chunk.range_start + pos_ : chunk.array[pos_]);
+            return;
+        }
+
+        chunk_++;
+        pos_ = 0;
+        bits_ = 0;
+    }
+    value_ = 0;
+}
+
+ResultSet::Iterator& ResultSet::Iterator::operator++() {
+    if (chunk_ < set_->chunks_.size() && set_->chunks_[chunk_].kind == Kind::Bitmap) {
+        bits_ &= bits_ - 1;
+        if (bits_ == 0) {
+            pos_++;
+        }
+    } else {
+        pos_++;
+    }
+    load();
+    return *this;
+}
@@ -0,0 +1,45 @@
+#include "utils/scroll_anchor.hpp"
+
+#include <algorithm>
+
+void ScrollAnchor::scroll_to(const HeightIndex& heights, double position) {
+    position = std::max(position, 0.0);
+    row_ = heights.row_at(position);
+    offset_ = position - heights.offset_of(row_);
+}
+
+void ScrollAnchor::scroll_by(const HeightIndex& heights, double delta) {
+    offset_ += delta;
+    // Short moves walk neighbouring rows, so the position never leaves (row, offset) form
+    for (size_t step = 0; step < MAX_WALK_ROWS; step++) {
+        if (offset_ < 0.0 && row_ > 0) {
+            row_--;
+            offset_ += heights.height(row_);
+        } else if (row_ + 1 < heights.row_count() && offset_ >= heights.height(row_)) {
+            offset_ -= heights.height(row_);
+            row_++;
+        } else {
+            return;
+        }
+    }
+    scroll_to(heights, position(heights));
+}
+
+void ScrollAnchor::clamp(const HeightIndex& heights, double view_height) {
+    if (heights.row_count() == 0) {
+        row_ = 0;
+        offset_ = 0.0;
+        return;
+    }
+    if (row_ >= heights.row_count()) {
+        row_ = heights.row_count() - 1;
+        offset_ = 0.0;
+    }
+    double max_position = std::max(0.0, heights.total_height() - view_height);
+    if (position(heights) > max_position) {
+        scroll_to(heights, max_position);
+    }
+    if (row_ == 0 && offset_ < 0.0) {
+        offset_ = 0.0;
+    }
+}
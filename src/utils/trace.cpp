@@ -0,0 +1,210 @@
+#include "utils/trace.hpp"
+
+#include "utils/json_formatter.hpp"
+#include "utils/memory_stats.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace {
+constexpr const char* TRACE_ENV = "JSON_VIEWER_TRACE";
+constexpr const char* DEFAULT_TRACE_PATH = "json_viewer_trace.json";
+constexpr size_t CHUNK_EVENTS = 16384;                     // 512KB per chunk
+constexpr size_t MAX_EVENTS_PER_THREAD = 64 * CHUNK_EVENTS; // 32MB per thread at most
+constexpr size_t OUTPUT_BUFFER_SIZE = 1024ULL * 1024ULL;
+constexpr int PROCESS_ID = 1;
+
+struct Event {
+    const char* name;
+    int64_t time_ns;
+    double value; // Counters only
+    char phase;   // Chrome trace-event phase: 'B', 'E' or 'C'
+};
+
+// Written by its thread only: events below `count` are final, so readers
+// need no lock
+struct Chunk {
+    std::array<Event, CHUNK_EVENTS> events;
+    std::atomic<size_t> count{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    int thread_id = 0;
+    std::string name;                 // Guarded by Registry::mutex
+    std::atomic<Chunk*> head{nullptr};
+    Chunk* tail = nullptr;            // Owning thread only
+    size_t recorded = 0;              // Owning thread only
+
+    ThreadBuffer() = default;
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+    ~ThreadBuffer() {
+        Chunk* chunk = head.load();
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+    }
+};
+
+// Buffers outlive their threads, so a trace written at exit still has them
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local ThreadBuffer* local_buffer = nullptr;
+std::atomic<size_t> chunk_count{0};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+const int64_t trace_epoch_ns = now_ns();
+
+ThreadBuffer& thread_buffer() {
+    if (local_buffer == nullptr) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread_id = static_cast<int>(reg.buffers.size()) + 1;
+        local_buffer = buffer.get();
+        reg.buffers.push_back(std::move(buffer));
+    }
+    return *local_buffer;
+}
+
+void record(char phase, const char* name, double value) {
+    ThreadBuffer& buffer = thread_buffer();
+    if (buffer.recorded >= MAX_EVENTS_PER_THREAD) {
+        return;
+    }
+    Chunk* chunk = buffer.tail;
+    size_t count = chunk != nullptr ? chunk->count.load(std::memory_order_relaxed) : 0;
+    if (chunk == nullptr || count == CHUNK_EVENTS) {
+        auto* next = new Chunk;
+        chunk_count++;
+        if (chunk == nullptr) {
+            buffer.head.store(next, std::memory_order_release);
+        } else {
+            chunk->next.store(next, std::memory_order_release);
+        }
+        buffer.tail = next;
+        chunk = next;
+        count = 0;
+    }
+    chunk->events[count] = {name, now_ns(), value, phase};
+    chunk->count.store(count + 1, std::memory_order_release);
+    buffer.recorded++;
+}
+
+void write_event(std::FILE* file, const Event& event, int thread_id) {
+    double time_us = static_cast<double>(event.time_ns - trace_epoch_ns) / 1000.0;
+    std::fputs(",\n{\"name\":", file);
+    std::fputs(json_string(event.name).c_str(), file);
+    std::fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d", event.phase, time_us,
+                 PROCESS_ID, thread_id);
+    if (event.phase == 'C') {
+        std::fprintf(file, ",\"args\":{\"value\":%.17g}", event.value);
+    }
+    std::fputc('}', file);
+}
+} // namespace
+
+REGISTER_MEMORY_REPORTER(trace_buffers, [] { return chunk_count.load() * sizeof(Chunk); });
+
+void set_trace_enabled(bool enabled) {
+    trace_detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void trace_thread_name(const std::string& name) {
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+void trace_begin(const char* name) {
+    if (trace_enabled()) {
+        record('B', name, 0.0);
+    }
+}
+
+void trace_end(const char* name) {
+    if (trace_enabled()) {
+        record('E', name, 0.0);
+    }
+}
+
+void trace_counter(const char* name, double value) {
+    if (trace_enabled()) {
+        record('C', name, value);
+    }
+}
+
+bool write_trace(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                       "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                       "\"args\":{\"name\":\"json_viewer\"}}",
+                 PROCESS_ID);
+
+    // Blocks only threads recording for the first time; events appended while
+    // writing are either included or not, never torn
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->name.empty()) {
+            std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                               "\"args\":{\"name\":",
+                         PROCESS_ID, buffer->thread_id);
+            std::fputs(json_string(buffer->name).c_str(), file);
+            std::fputs("}}", file);
+        }
+        for (const Chunk* chunk = buffer->head.load(std::memory_order_acquire); chunk != nullptr;
+             chunk = chunk->next.load(std::memory_order_acquire)) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                write_event(file, chunk->events[i], buffer->thread_id);
+            }
+        }
+    }
+    std::fputs("\n]}\n", file);
+
+    bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+std::string trace_output_path() {
+    const char* path = std::getenv(TRACE_ENV);
+    return path != nullptr && path[0] != '\0' ? path : DEFAULT_TRACE_PATH;
+}
+
+bool start_trace_from_environment() {
+    const char* path = std::getenv(TRACE_ENV);
+    if (path == nullptr || path[0] == '\0') {
+        return false;
+    }
+    set_trace_enabled(true);
+    return true;
+}
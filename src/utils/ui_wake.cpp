@@ -0,0 +1,28 @@
+#include "utils/ui_wake.hpp"
+
+#include <atomic>
+
+namespace {
+std::atomic<UiWakeFn> wake_callback{nullptr};
+std::atomic<bool> wake_pending{false};
+} // namespace
+
+void set_ui_wake_callback(UiWakeFn callback) {
+    wake_callback.store(callback);
+    // Work started before the UI existed (e.g. a load from the command line)
+    // may have left a request that posted nothing; re-arm for the next one
+    wake_pending.store(false, std::memory_order_release);
+}
+
+void request_ui_wake() {
+    if (wake_pending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (UiWakeFn callback = wake_callback.load(std::memory_order_acquire)) {
+        callback();
+    }
+}
+
+void acknowledge_ui_wake() {
+    wake_pending.store(false, std::memory_order_release);
+}
@@ -0,0 +1,104 @@
+#include "test_check.hpp"
+#include "utils/byte_budget_cache.hpp"
+
+#include <cstddef>
+
+namespace {
+constexpr size_t BUDGET_BYTES = 1000;
+constexpr size_t ENTRY_BYTES = 100;
+
+void check_budget() {
+    ByteBudgetCache<int, int> cache(BUDGET_BYTES);
+    for (int key = 0; key < 50; key++) {
+        cache.insert(key, key, ENTRY_BYTES);
+        CHECK(cache.stats().bytes <= BUDGET_BYTES);
+    }
+    CacheStats stats = cache.stats();
+    CHECK(stats.entries > 0);
+    CHECK(stats.entries <= BUDGET_BYTES / ENTRY_BYTES);
+    CHECK(stats.evictions + stats.rejections > 0);
+
+    // Larger than the whole budget: never cached
+    cache.insert(100, 100, BUDGET_BYTES + 1);
+    CHECK(cache.find(100) == nullptr);
+
+    // Shrinking the budget evicts down to it
+    cache.set_budget(BUDGET_BYTES / 2);
+    CHECK(cache.stats().bytes <= BUDGET_BYTES / 2);
+}
+
+void check_scan_resistance() {
+    ByteBudgetCache<int, int> cache(BUDGET_BYTES);
+    cache.insert(0, 42, ENTRY_BYTES);
+    for (int access = 0; access < 5; access++) {
+        CHECK(cache.find(0) != nullptr);
+    }
+
+    // A burst of one-off entries must not flush the frequently used one
+    for (int key = 1; key < 200; key++) {
+        cache.insert(key, key, ENTRY_BYTES);
+    }
+    const int* value = cache.find(0);
+    CHECK(value != nullptr && *value == 42);
+
+    // Scan traffic bypasses the cache entirely
+    cache.insert(500, 500, ENTRY_BYTES, CacheHint::Scan);
+    CHECK(cache.find(500, CacheHint::Scan) == nullptr);
+}
+
+// Fills the main region with entries looked up (and missed) before insertion, so each is
+// more popular than `key` and evicts whatever sits in probation
+bool survives_popular_inserts(CacheHint hint) {
+    ByteBudgetCache<int, int> cache(BUDGET_BYTES);
+    int key = 0;
+    cache.insert(key, key, ENTRY_BYTES);
+    for (int access = 0; access < 3; access++) {
+        cache.find(key, hint);
+    }
+    for (int other = 1; other < 10; other++) {
+        cache.find(other);
+        cache.find(other);
+        cache.insert(other, other, ENTRY_BYTES);
+    }
+    return cache.find(key, CacheHint::Scan) != nullptr;
+}
+
+void check_scan_lookups() {
+    // A Normal hit promotes a probation entry to protected; a Scan lookup must not
+    CHECK(survives_popular_inserts(CacheHint::Normal));
+    CHECK(!survives_popular_inserts(CacheHint::Scan));
+
+    // Nor does it count as a hit or a miss
+    ByteBudgetCache<int, int> cache(BUDGET_BYTES);
+    cache.insert(1, 1, ENTRY_BYTES);
+    CHECK(cache.find(1, CacheHint::Scan) != nullptr);
+    CHECK(cache.find(2, CacheHint::Scan) == nullptr);
+    CHECK(cache.stats().hits == 0);
+    CHECK(cache.stats().misses == 0);
+}
+
+void check_erase_and_clear() {
+    ByteBudgetCache<int, int> cache(BUDGET_BYTES);
+    cache.insert(1, 1, ENTRY_BYTES);
+    cache.insert(1, 2, ENTRY_BYTES); // Replaces
+    const int* value = cache.find(1);
+    CHECK(value != nullptr && *value == 2);
+    CHECK(cache.stats().entries == 1);
+
+    cache.erase(1);
+    CHECK(cache.find(1) == nullptr);
+    CHECK(cache.stats().bytes == 0);
+
+    cache.insert(2, 2, ENTRY_BYTES);
+    cache.clear();
+    CHECK(cache.stats().entries == 0);
+    CHECK(cache.stats().bytes == 0);
+}
+} // namespace
+
+void test_byte_budget_cache() {
+    check_budget();
+    check_scan_resistance();
+    check_scan_lookups();
+    check_erase_and_clear();
+}
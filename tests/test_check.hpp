@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the unit tests: a failed CHECK is reported and counted,
+// and the run continues. Unlike assert, it is not compiled out under NDEBUG.
+int& check_failures();
+
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            check_failures()++;                                                                    \
+        }                                                                                          \
+    } while (false)
+
+// One function per tested unit, each in its own test_<unit>.cpp
+void test_result_set();
+void test_byte_budget_cache();
+void test_height_index();
+void test_index_file();
+void test_json_formatter();
@@ -0,0 +1,83 @@
+#include "test_check.hpp"
+#include "utils/height_index.hpp"
+
+#include <cstdint>
+
+namespace {
+constexpr double ROW_HEIGHT = 20.0;
+
+void check_prefix_sums() {
+    HeightIndex heights;
+    heights.reset(10000, ROW_HEIGHT);
+    CHECK(heights.total_height() == 10000 * ROW_HEIGHT);
+    CHECK(heights.offset_of(123) == 123 * ROW_HEIGHT);
+
+    // Measured rows in two different blocks
+    heights.set_height(5, 100.0);
+    heights.set_height(5000, 50.0);
+    CHECK(heights.measured_rows() == 2);
+    CHECK(heights.height(5) == 100.0);
+    CHECK(heights.height(6) == ROW_HEIGHT);
+    CHECK(heights.offset_of(5) == 5 * ROW_HEIGHT);
+    CHECK(heights.offset_of(6) == 5 * ROW_HEIGHT + 100.0);
+    CHECK(heights.offset_of(5001) == 5001 * ROW_HEIGHT + 80.0 + 30.0);
+    CHECK(heights.total_height() == 10000 * ROW_HEIGHT + 80.0 + 30.0);
+
+    // Back to the default height drops the measurement
+    heights.set_height(5, ROW_HEIGHT);
+    CHECK(heights.measured_rows() == 1);
+    CHECK(heights.offset_of(6) == 6 * ROW_HEIGHT);
+
+    // Out of range rows are ignored
+    heights.set_height(10000, 1000.0);
+    CHECK(heights.measured_rows() == 1);
+}
+
+void check_row_at() {
+    HeightIndex heights;
+    heights.reset(10000, ROW_HEIGHT);
+    heights.set_height(5, 100.0);
+    heights.set_height(5000, 50.0);
+    for (uint64_t row : {0ULL, 4ULL, 5ULL, 6ULL, 4999ULL, 5000ULL, 5001ULL, 9999ULL}) {
+        CHECK(heights.row_at(heights.offset_of(row)) == row);
+        CHECK(heights.row_at(heights.offset_of(row) + heights.height(row) - 1.0) == row);
+    }
+    CHECK(heights.row_at(-1.0) == 0);
+    CHECK(heights.row_at(heights.total_height() * 2) == 9999);
+
+    HeightIndex empty;
+    empty.reset(0, ROW_HEIGHT);
+    CHECK(empty.row_at(100.0) == 0);
+    CHECK(empty.total_height() == 0.0);
+}
+
+void check_resize() {
+    HeightIndex heights;
+    heights.reset(10000, ROW_HEIGHT);
+    heights.set_height(5, 100.0);
+    heights.set_height(5000, 50.0);
+
+    heights.resize(5000);
+    CHECK(heights.measured_rows() == 1);
+    CHECK(heights.total_height() == 5000 * ROW_HEIGHT + 80.0);
+
+    heights.resize(20000);
+    CHECK(heights.total_height() == 20000 * ROW_HEIGHT + 80.0);
+    heights.set_height(19999, 40.0);
+    CHECK(heights.offset_of(19999) == 19999 * ROW_HEIGHT + 80.0);
+    CHECK(heights.total_height() == 20000 * ROW_HEIGHT + 100.0);
+
+    // Far past 2^31 rows offsets stay exact
+    uint64_t rows = 3000000000ULL;
+    heights.reset(rows, ROW_HEIGHT);
+    heights.set_height(rows - 1, 2 * ROW_HEIGHT);
+    CHECK(heights.offset_of(rows - 1) == static_cast<double>(rows - 1) * ROW_HEIGHT);
+    CHECK(heights.row_at(heights.offset_of(rows - 1)) == rows - 1);
+}
+} // namespace
+
+void test_height_index() {
+    check_prefix_sums();
+    check_row_at();
+    check_resize();
+}
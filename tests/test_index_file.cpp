@@ -0,0 +1,99 @@
+#include "test_check.hpp"
+#include "utils/index_file.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr const char* NDJSON = "{\"a\":1}\n{\"b\":2}\n{\"c\":3}\n";
+// Sidecar header: magic plus four 64-bit fields
+constexpr long HEADER_BYTES = 8 + 4 * sizeof(uint64_t);
+
+std::string write_source() {
+    std::string path =
+        (std::filesystem::temp_directory_path() / "json_viewer_test_index.ndjson").string();
+    std::ofstream(path, std::ios::binary) << NDJSON;
+    return path;
+}
+
+DatasetSnapshot make_snapshot() {
+    auto dataset = std::make_shared<Dataset>();
+    dataset->raw_data = simdjson::padded_string(std::string(NDJSON));
+    dataset->index = {{0, 7}, {8, 7}, {16, 7}};
+    return {dataset, 1};
+}
+
+// Overwrites one 64-bit field of the sidecar
+void patch_sidecar(const std::string& path, long offset, uint64_t value) {
+    std::FILE* file = std::fopen(index_file_path(path).c_str(), "r+b");
+    CHECK(file != nullptr);
+    if (file == nullptr) {
+        return;
+    }
+    std::fseek(file, offset, SEEK_SET);
+    std::fwrite(&value, sizeof(value), 1, file);
+    std::fclose(file);
+}
+
+void remove_files(const std::string& path) {
+    std::remove(index_file_path(path).c_str());
+    std::remove(path.c_str());
+}
+} // namespace
+
+void test_index_file() {
+    std::string path = write_source();
+    DatasetSnapshot snapshot = make_snapshot();
+    size_t raw_size = snapshot.raw_size();
+
+    // Round trip
+    CHECK(save_index_file(path, snapshot));
+    std::vector<DocumentIndex> index;
+    CHECK(load_index_file(path, raw_size, index));
+    CHECK(index.size() == 3);
+    CHECK(index.size() == 3 && index[2].byte_offset_ == 16 && index[2].byte_length_ == 7);
+
+    // Stale: the raw size no longer matches
+    index.clear();
+    CHECK(!load_index_file(path, raw_size + 1, index));
+    CHECK(index.empty());
+
+    // An offset past the raw data is rejected and the output left untouched
+    patch_sidecar(path, HEADER_BYTES + 2 * sizeof(DocumentIndex), raw_size + 1);
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(index.empty());
+
+    // So is a length that runs past the end
+    CHECK(save_index_file(path, snapshot));
+    patch_sidecar(path, HEADER_BYTES + sizeof(DocumentIndex) + sizeof(uint64_t), raw_size);
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(index.empty());
+
+    // And a length chosen so that offset + length wraps around
+    CHECK(save_index_file(path, snapshot));
+    patch_sidecar(path, HEADER_BYTES + 2 * sizeof(DocumentIndex) + sizeof(uint64_t), UINT64_MAX);
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(index.empty());
+
+    // A document count that does not match the entries is rejected before it is allocated
+    CHECK(save_index_file(path, snapshot));
+    patch_sidecar(path, HEADER_BYTES - sizeof(uint64_t), UINT64_MAX / 2);
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(save_index_file(path, snapshot));
+    patch_sidecar(path, HEADER_BYTES - sizeof(uint64_t), 2);
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(index.empty());
+
+    // A truncated sidecar is rejected
+    CHECK(save_index_file(path, snapshot));
+    std::filesystem::resize_file(index_file_path(path), HEADER_BYTES + sizeof(DocumentIndex));
+    CHECK(!load_index_file(path, raw_size, index));
+    CHECK(index.empty());
+
+    remove_files(path);
+}
@@ -0,0 +1,16 @@
+#include "test_check.hpp"
+#include "utils/json_formatter.hpp"
+
+#include <string>
+
+void test_json_formatter() {
+    CHECK(json_string("plain") == "\"plain\"");
+    CHECK(json_string("a\"b\\c") == "\"a\\\"b\\\\c\"");
+    CHECK(json_string("tab\there\nnext") == "\"tab\\u0009here\\u000anext\"");
+    CHECK(json_string(std::string("nul\0", 4)) == "\"nul\\u0000\"");
+    CHECK(json_string("caf\xC3\xA9") == "\"caf\xC3\xA9\""); // UTF-8 passes through
+
+    std::string out = "[";
+    append_json_string(out, "x");
+    CHECK(out == "[\"x\"");
+}
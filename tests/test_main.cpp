@@ -1,13 +1,25 @@
-#include "../include/main.hpp"
-#include <cassert>
+#include "test_check.hpp"
+
 #include <iostream>
 
+int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
 int main() {
     std::cout << "Running tests..." << std::endl;
-    
-    // Add your tests here
-    // Example: assert(some_function() == expected_value);
-    
-    std::cout << "✅ All tests passed!" << std::endl;
+
+    test_result_set();
+    test_byte_budget_cache();
+    test_height_index();
+    test_index_file();
+    test_json_formatter();
+
+    if (check_failures() != 0) {
+        std::cout << check_failures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed!" << std::endl;
     return 0;
 }
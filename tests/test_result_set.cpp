@@ -0,0 +1,104 @@
+#include "test_check.hpp"
+#include "utils/result_set.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+// Members of a set through its iterator
+std::vector<uint64_t> members(const ResultSet& set) {
+    std::vector<uint64_t> values;
+    for (uint64_t value : set) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+// A set with one chunk of each kind: sparse array, dense bitmap, full range
+ResultSet mixed_set() {
+    ResultSet set;
+    for (uint64_t index = 0; index < 100; index++) {
+        set.add(index * 7);
+    }
+    for (uint64_t index = 65536; index < 65536 + 20000; index += 2) {
+        set.add(index);
+    }
+    set.append(ResultSet::range(2 * 65536, 3 * 65536));
+    return set;
+}
+
+void check_membership() {
+    ResultSet set = mixed_set();
+    CHECK(set.size() == 100 + 10000 + 65536);
+    CHECK(set.contains(0));
+    CHECK(set.contains(693));
+    CHECK(!set.contains(694));
+    CHECK(set.contains(65536 + 19998));
+    CHECK(!set.contains(65536 + 19999));
+    CHECK(set.contains(3 * 65536 - 1));
+    CHECK(!set.contains(3 * 65536));
+
+    ResultSet all = ResultSet::all(200000);
+    CHECK(all.size() == 200000);
+    CHECK(all.contains(199999));
+    CHECK(!all.contains(200000));
+    CHECK(ResultSet().empty());
+}
+
+void check_rank() {
+    ResultSet set = mixed_set();
+    std::vector<uint64_t> values = members(set);
+    CHECK(values.size() == set.size());
+    for (uint64_t rank : {0ULL, 1ULL, 99ULL, 100ULL, 5000ULL, 10099ULL, 10100ULL, 75635ULL}) {
+        CHECK(set.select(rank) == values[rank]);
+        CHECK(*set.iterator_at(rank) == values[rank]);
+    }
+    CHECK(set.iterator_at(set.size()) == set.end());
+
+    // Indices past 2^32 keep their high bits
+    ResultSet high = ResultSet::range(5000000000ULL, 5000000010ULL);
+    CHECK(high.select(3) == 5000000003ULL);
+}
+
+void check_set_ops() {
+    ResultSet evens;
+    ResultSet threes;
+    for (uint64_t index = 0; index < 150000; index++) {
+        if (index % 2 == 0) {
+            evens.add(index);
+        }
+        if (index % 3 == 0) {
+            threes.add(index);
+        }
+    }
+    ResultSet both = evens & threes;
+    ResultSet either = evens | threes;
+    ResultSet evens_only = evens - threes;
+    ResultSet neither = either.complement(150000);
+
+    CHECK(both.size() == 25000);
+    CHECK(either.size() == 100000);
+    CHECK(evens_only.size() == 50000);
+    CHECK(neither.size() == 50000);
+    for (uint64_t index : {0ULL, 1ULL, 2ULL, 3ULL, 6ULL, 7ULL, 65537ULL, 149999ULL}) {
+        CHECK(both.contains(index) == (index % 6 == 0));
+        CHECK(either.contains(index) == (index % 2 == 0 || index % 3 == 0));
+        CHECK(evens_only.contains(index) == (index % 2 == 0 && index % 3 != 0));
+        CHECK(neither.contains(index) == (index % 2 != 0 && index % 3 != 0));
+    }
+
+    // Identities
+    CHECK((evens | ResultSet()) == evens);
+    CHECK((evens & ResultSet()).empty());
+    CHECK((evens - evens).empty());
+    CHECK((both | evens_only) == evens);
+    CHECK(neither.complement(150000) == either);
+    CHECK(ResultSet().complement(150000) == ResultSet::all(150000));
+}
+} // namespace
+
+void test_result_set() {
+    check_membership();
+    check_rank();
+    check_set_ops();
+}
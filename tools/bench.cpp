@@ -0,0 +1,397 @@
+// Throughput benchmark for the engine: loading, inflate, NDJSON indexing,
+// search, formatting and the document cache.
+//
+//   bench [--iterations N] [--query TEXT] [--output PATH] [--no-gzip] [FILE...]
+//
+// Every FILE (.json, .ndjson or .gz) is measured in turn; without files a
+// synthetic NDJSON dataset is generated (deterministically) in the temp
+// directory. Each benchmark runs N times and reports the median in MB/s and
+// documents/s. Results are written as JSON (stdout by default), progress to
+// stderr, so runs can be stored and compared across commits.
+
+#include "utils/byte_budget_cache.hpp"
+#include "utils/document_search.hpp"
+#include "utils/job_system.hpp"
+#include "utils/json_data_store.hpp"
+#include "utils/json_formatter.hpp"
+#include "utils/json_parser.hpp"
+#include "utils/loading_state.hpp"
+#include "utils/parallel_search.hpp"
+#include "utils/parser_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+#ifndef BENCH_GIT_REVISION
+    #define BENCH_GIT_REVISION ""
+#endif
+#ifndef BENCH_BUILD_TYPE
+    #define BENCH_BUILD_TYPE ""
+#endif
+
+namespace {
+constexpr size_t DEFAULT_ITERATIONS = 5;
+constexpr const char* DEFAULT_QUERY = "error";
+constexpr size_t SYNTHETIC_DOCUMENTS = 500000;
+constexpr uint64_t SYNTHETIC_SEED = 42;
+constexpr size_t INDEX_BATCH_SIZE = 1024ULL * 1024ULL;            // Same batch as the loader
+constexpr size_t FORMAT_BUDGET_BYTES = 64ULL * 1024ULL * 1024ULL; // Raw bytes formatted per run
+constexpr size_t CACHE_BENCH_BYTES = 16ULL * 1024ULL * 1024ULL;   // Well inside the cache budget
+constexpr size_t GZ_BUFFER_SIZE = 1024ULL * 1024ULL;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+using Clock = std::chrono::steady_clock;
+
+// Results nothing else reads are stored here so the work is not optimized away
+volatile size_t benchmark_sink = 0;
+
+struct Options {
+    size_t iterations = DEFAULT_ITERATIONS;
+    std::string query = DEFAULT_QUERY;
+    std::string output_path; // Empty: stdout
+    bool gzip = true;
+    std::vector<std::string> files;
+};
+
+// Work done by one run of a benchmark
+struct Work {
+    size_t bytes = 0;
+    size_t documents = 0;
+};
+
+struct Result {
+    std::string name;
+    Work work;
+    std::vector<double> seconds; // One per iteration
+
+    double median() const {
+        std::vector<double> sorted = seconds;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[sorted.size() / 2];
+    }
+    double min() const { return *std::min_element(seconds.begin(), seconds.end()); }
+};
+
+struct DatasetResults {
+    std::string path;
+    size_t bytes = 0;
+    size_t documents = 0;
+    std::vector<Result> results;
+};
+
+bool ends_with(std::string_view str, std::string_view suffix) {
+    return str.size() >= suffix.size() && str.substr(str.size() - suffix.size()) == suffix;
+}
+
+std::optional<Options> parse_args(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--iterations" && has_value) {
+            options.iterations = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--query" && has_value) {
+            options.query = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            options.output_path = argv[++i];
+        } else if (arg == "--no-gzip") {
+            options.gzip = false;
+        } else if (arg.starts_with("--")) {
+            return std::nullopt;
+        } else {
+            options.files.emplace_back(arg);
+        }
+    }
+    if (options.query.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+// Runs `body` once untimed (warm-up) and then `iterations` times
+Result measure(const std::string& name, size_t iterations, const std::function<Work()>& body) {
+    Result result{name, body(), {}};
+    for (size_t i = 0; i < iterations; i++) {
+        Clock::time_point start = Clock::now();
+        result.work = body();
+        result.seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    double seconds = result.median();
+    std::fprintf(stderr, "  %-18s %10.1f MB/s %14.0f docs/s\n", name.c_str(),
+                 static_cast<double>(result.work.bytes) / BYTES_PER_MB / seconds,
+                 static_cast<double>(result.work.documents) / seconds);
+    return result;
+}
+
+// Log-like records: a few hot values, a long tail of ids, one in 50 an error
+bool write_synthetic_dataset(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    constexpr std::array<const char*, 4> LEVELS = {"debug", "info", "warn", "error"};
+    std::mt19937_64 rng(SYNTHETIC_SEED);
+    for (size_t i = 0; i < SYNTHETIC_DOCUMENTS; i++) {
+        uint64_t value = rng();
+        const char* level = LEVELS.at(value % 50 == 0 ? 3 : value % 3);
+        std::fprintf(file,
+                     "{\"id\":%zu,\"level\":\"%s\",\"user\":\"user%llu\",\"latency_ms\":%llu,"
+                     "\"tags\":[\"svc%llu\",\"region%llu\"],\"message\":\"request %016llx\"}\n",
+                     i, level, static_cast<unsigned long long>((value >> 8) % 100000),
+                     static_cast<unsigned long long>((value >> 24) % 5000),
+                     static_cast<unsigned long long>((value >> 40) % 16),
+                     static_cast<unsigned long long>((value >> 48) % 8),
+                     static_cast<unsigned long long>(value));
+    }
+    return std::fclose(file) == 0;
+}
+
+bool write_gzip_copy(const std::string& source, const std::string& destination) {
+    std::FILE* input = std::fopen(source.c_str(), "rb");
+    if (input == nullptr) {
+        return false;
+    }
+    gzFile output = gzopen(destination.c_str(), "wb6");
+    if (output == nullptr) {
+        std::fclose(input);
+        return false;
+    }
+    std::vector<char> buffer(GZ_BUFFER_SIZE);
+    bool ok = true;
+    size_t bytes_read = 0;
+    while (ok && (bytes_read = std::fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+        ok = gzwrite(output, buffer.data(), static_cast<unsigned>(bytes_read)) ==
+             static_cast<int>(bytes_read);
+    }
+    std::fclose(input);
+    return gzclose(output) == Z_OK && ok;
+}
+
+// Full loader path; false if the file did not load
+bool load(const std::string& path) {
+    json_parser(path);
+    if (!get_loading_state().is_complete) {
+        std::fprintf(stderr, "error: %s: %s\n", path.c_str(),
+                     get_loading_state().error_message.c_str());
+        return false;
+    }
+    return true;
+}
+
+Work load_work() {
+    DatasetSnapshot snapshot = get_json_data().snapshot();
+    return {snapshot.raw_size(), snapshot.document_count()};
+}
+
+bool run_dataset(const std::string& path, const Options& options, DatasetResults& dataset) {
+    size_t iterations = options.iterations;
+    std::fprintf(stderr, "%s\n", path.c_str());
+    if (!load(path)) {
+        return false;
+    }
+    DatasetSnapshot snapshot = get_json_data().snapshot();
+    dataset.path = path;
+    dataset.bytes = snapshot.raw_size();
+    dataset.documents = snapshot.document_count();
+    bool is_ndjson = ends_with(path, ".ndjson") || ends_with(path, ".ndjson.gz");
+
+    // A saved sidecar index skips indexing; label the result so it is not compared with a full load
+    bool has_sidecar = std::filesystem::exists(path + ".jvidx");
+    std::string load_name = ends_with(path, ".gz") ? "load_gzip" : "load";
+    dataset.results.push_back(
+        measure(has_sidecar ? load_name + "_saved_index" : load_name, iterations, [&path]() {
+            load(path);
+            return load_work();
+        }));
+
+    // Inflate cost for plain inputs, from a temporary compressed copy
+    if (options.gzip && !ends_with(path, ".gz")) {
+        // data.ndjson -> data.bench.ndjson.gz, so the loader still sees NDJSON
+        std::filesystem::path source(path);
+        std::string gz_path = (std::filesystem::temp_directory_path() /
+                               (source.stem().string() + ".bench" +
+                                source.extension().string() + ".gz"))
+                                  .string();
+        if (write_gzip_copy(path, gz_path)) {
+            dataset.results.push_back(measure("load_gzip", iterations, [&gz_path]() {
+                load(gz_path);
+                return load_work();
+            }));
+            std::filesystem::remove(gz_path);
+        }
+        // Leave the plain file loaded for the in-memory benchmarks
+        load(path);
+        snapshot = get_json_data().snapshot();
+    }
+
+    // NDJSON document boundaries alone, as the loader finds them
+    if (is_ndjson) {
+        dataset.results.push_back(measure("index_ndjson", iterations, [&snapshot]() {
+            std::string_view raw = snapshot.raw_data();
+            simdjson::ondemand::parser& parser = local_ondemand_parser(INDEX_BATCH_SIZE);
+            simdjson::ondemand::document_stream stream;
+            size_t documents = 0;
+            if (parser.iterate_many(raw.data(), raw.size(), INDEX_BATCH_SIZE).get(stream) ==
+                simdjson::SUCCESS) {
+                for (auto iter = stream.begin(); iter != stream.end(); ++iter) {
+                    documents++;
+                }
+            }
+            return Work{raw.size(), documents};
+        }));
+    }
+
+    SearchQuery query{SearchKind::Substring, options.query};
+    dataset.results.push_back(measure("search_parallel", iterations, [&]() {
+        SearchResults results;
+        ParallelSearch search(query, snapshot, JobPriority::High);
+        search.wait();
+        search.collect(results, std::numeric_limits<size_t>::max());
+        return Work{snapshot.raw_size(), snapshot.document_count()};
+    }));
+    dataset.results.push_back(measure("search_single", iterations, [&]() {
+        size_t matches = 0;
+        for (size_t i = 0; i < snapshot.document_count(); i++) {
+            matches += document_matches(query, snapshot.document(i)) ? 1 : 0;
+        }
+        benchmark_sink = matches;
+        return Work{snapshot.raw_size(), snapshot.document_count()};
+    }));
+
+    // Pretty-printing from the front of the file, up to FORMAT_BUDGET_BYTES
+    dataset.results.push_back(measure("format_json", iterations, [&snapshot]() {
+        std::pmr::unsynchronized_pool_resource pool;
+        Work work;
+        for (size_t i = 0; i < snapshot.document_count() && work.bytes < FORMAT_BUDGET_BYTES;
+             i++) {
+            std::string_view document = snapshot.document(i);
+            FormattedJson formatted = format_json(document, true, &pool);
+            work.bytes += document.size();
+            work.documents++;
+        }
+        return work;
+    }));
+
+    // Document cache: copies that bypass it vs. hits on a warmed working set
+    size_t cache_documents = 0;
+    for (size_t bytes = 0; cache_documents < snapshot.document_count() &&
+                           bytes + snapshot.document(cache_documents).size() < CACHE_BENCH_BYTES;
+         cache_documents++) {
+        bytes += snapshot.document(cache_documents).size();
+    }
+    auto read_documents = [cache_documents](CacheHint hint) {
+        Work work;
+        for (size_t i = 0; i < cache_documents; i++) {
+            work.bytes += get_json_data().get_document(i, hint).size();
+            work.documents++;
+        }
+        return work;
+    };
+    if (cache_documents > 0) {
+        dataset.results.push_back(measure("document_copy", iterations, [&read_documents]() {
+            return read_documents(CacheHint::Scan);
+        }));
+        read_documents(CacheHint::Normal); // Second access promotes into the protected segment
+        dataset.results.push_back(measure("document_cache_hit", iterations, [&read_documents]() {
+            return read_documents(CacheHint::Normal);
+        }));
+    }
+    return true;
+}
+
+void write_report(std::FILE* out, const Options& options,
+                  const std::vector<DatasetResults>& datasets) {
+    std::fprintf(out, "{\n  \"revision\": %s,\n  \"build_type\": %s,\n",
+                 json_string(BENCH_GIT_REVISION).c_str(), json_string(BENCH_BUILD_TYPE).c_str());
+    std::fprintf(out, "  \"cpu_count\": %zu,\n  \"iterations\": %zu,\n  \"query\": %s,\n",
+                 available_cpu_count(), options.iterations, json_string(options.query).c_str());
+    std::fprintf(out, "  \"datasets\": [");
+    for (size_t d = 0; d < datasets.size(); d++) {
+        const DatasetResults& dataset = datasets[d];
+        std::fprintf(out, "%s\n    {\n      \"path\": %s,\n", d == 0 ? "" : ",",
+                     json_string(dataset.path).c_str());
+        std::fprintf(out, "      \"bytes\": %zu,\n      \"documents\": %zu,\n", dataset.bytes,
+                     dataset.documents);
+        std::fprintf(out, "      \"benchmarks\": [");
+        for (size_t r = 0; r < dataset.results.size(); r++) {
+            const Result& result = dataset.results[r];
+            double median = result.median();
+            std::fprintf(out,
+                         "%s\n        {\"name\": %s, \"bytes\": %zu, \"documents\": %zu, "
+                         "\"median_s\": %.6f, \"min_s\": %.6f, \"mb_per_s\": %.2f, "
+                         "\"docs_per_s\": %.0f}",
+                         r == 0 ? "" : ",", json_string(result.name).c_str(), result.work.bytes,
+                         result.work.documents, median, result.min(),
+                         static_cast<double>(result.work.bytes) / BYTES_PER_MB / median,
+                         static_cast<double>(result.work.documents) / median);
+        }
+        std::fprintf(out, "\n      ]\n    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::optional<Options> options = parse_args(argc, argv);
+    if (!options) {
+        std::fputs("usage: bench [--iterations N] [--query TEXT] [--output PATH] [--no-gzip] "
+                   "[FILE...]\n",
+                   stderr);
+        return 2;
+    }
+
+    std::string synthetic_path;
+    if (options->files.empty()) {
+        synthetic_path =
+            (std::filesystem::temp_directory_path() / "json_viewer_bench.ndjson").string();
+        if (!write_synthetic_dataset(synthetic_path)) {
+            std::fprintf(stderr, "error: cannot write %s\n", synthetic_path.c_str());
+            return 1;
+        }
+        options->files.push_back(synthetic_path);
+    }
+
+    std::vector<DatasetResults> datasets;
+    int exit_code = 0;
+    for (const std::string& path : options->files) {
+        DatasetResults dataset;
+        if (run_dataset(path, *options, dataset)) {
+            datasets.push_back(std::move(dataset));
+        } else {
+            exit_code = 1;
+        }
+    }
+    if (!synthetic_path.empty()) {
+        std::filesystem::remove(synthetic_path);
+    }
+
+    std::FILE* out = options->output_path.empty() ? stdout
+                                                  : std::fopen(options->output_path.c_str(), "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "error: cannot open %s\n", options->output_path.c_str());
+        return 1;
+    }
+    write_report(out, *options, datasets);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    get_job_system().shutdown();
+    return exit_code;
+}
@@ -0,0 +1,499 @@
+// Deterministic synthetic dataset generator for benchmarks and regression runs.
+//
+//   gen_data --shape log|huge|long-lines|deep --size SIZE [--seed N]
+//            [--gzip | --gzip-members] [--level N] [--line-bytes SIZE] [--depth N]
+//            -o PATH
+//
+// Shapes:
+//   log         NDJSON log records with skewed field cardinalities
+//   huge        one JSON document: {"records": [ ...log records... ]}
+//   long-lines  NDJSON whose lines are --line-bytes long (default 4M)
+//   deep        NDJSON of objects/arrays nested --depth levels (default 256)
+// SIZE takes K/M/G suffixes; output is rounded up to whole records. `-o -`
+// writes to stdout. Name NDJSON output *.ndjson (or *.ndjson.gz) so the
+// viewer indexes it per line.
+//
+// The output is split into fixed-size blocks generated on every core, each
+// seeded from (seed, block index), so the same arguments always produce the
+// same bytes regardless of the machine. --gzip compresses into one gzip
+// member on the writer thread; --gzip-members compresses every block into
+// its own member in parallel (a multi-member file, and much faster).
+
+#include "utils/job_system.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+constexpr size_t BLOCK_BYTES = 8ULL * 1024ULL * 1024ULL; // Unit of parallel generation
+constexpr size_t BLOCKS_IN_FLIGHT_PER_CPU = 2;
+constexpr size_t DEFAULT_LINE_BYTES = 4ULL * 1024ULL * 1024ULL;
+constexpr size_t DEFAULT_DEPTH = 256;
+constexpr int DEFAULT_GZIP_LEVEL = 1;
+constexpr size_t GZIP_OUT_BUFFER = 1024ULL * 1024ULL;
+constexpr int GZIP_WINDOW_BITS = 15 + 16; // zlib: +16 selects the gzip wrapper
+constexpr int GZIP_MEM_LEVEL = 8;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+// Skewed vocabularies: low indices are drawn far more often than high ones
+constexpr std::array<std::string_view, 5> LEVELS = {"info", "debug", "warn", "error", "fatal"};
+constexpr std::array<std::string_view, 8> METHODS = {"GET",   "POST", "PUT",     "DELETE",
+                                                     "PATCH", "HEAD", "OPTIONS", "TRACE"};
+constexpr std::array<uint16_t, 8> STATUSES = {200, 404, 500, 302, 201, 401, 403, 503};
+constexpr size_t SERVICE_COUNT = 64;
+constexpr size_t USER_COUNT = 1000000;
+constexpr size_t PATH_COUNT = 5000;
+
+enum class Shape : uint8_t { Log, Huge, LongLines, Deep };
+enum class Compression : uint8_t { None, Gzip, GzipMembers };
+
+struct Options {
+    Shape shape = Shape::Log;
+    uint64_t size = 0;
+    uint64_t seed = 1;
+    Compression compression = Compression::None;
+    int level = DEFAULT_GZIP_LEVEL;
+    size_t line_bytes = DEFAULT_LINE_BYTES;
+    size_t depth = DEFAULT_DEPTH;
+    std::string output_path;
+};
+
+// SplitMix64: tiny, fast and good enough for test data
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t value = (state_ += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+    // Uniform in [0, count)
+    size_t uniform(size_t count) { return static_cast<size_t>(next() % count); }
+    // In [0, count), heavily biased towards 0 (cube of a uniform variate)
+    size_t skewed(size_t count) {
+        double unit = static_cast<double>(next() >> 11) * 0x1.0p-53;
+        return std::min(count - 1, static_cast<size_t>(unit * unit * unit * count));
+    }
+
+private:
+    uint64_t state_;
+};
+
+void append_number(std::string& out, uint64_t value) {
+    std::array<char, 24> digits{};
+    auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), end);
+}
+
+void append_hex(std::string& out, uint64_t value) {
+    std::array<char, 16> digits{};
+    for (size_t i = digits.size(); i-- > 0; value >>= 4) {
+        digits.at(i) = "0123456789abcdef"[value & 0xF];
+    }
+    out.append(digits.data(), digits.size());
+}
+
+void append_log_record(std::string& out, Random& random, uint64_t record_id) {
+    uint64_t timestamp = 1700000000000ULL + record_id * 7 + random.uniform(7);
+    out += "{\"ts\":";
+    append_number(out, timestamp);
+    out += ",\"level\":\"";
+    out += LEVELS.at(random.skewed(LEVELS.size()));
+    out += "\",\"service\":\"svc-";
+    append_number(out, random.skewed(SERVICE_COUNT));
+    out += "\",\"request_id\":\"";
+    append_hex(out, random.next());
+    out += "\",\"user\":\"user";
+    append_number(out, random.skewed(USER_COUNT));
+    out += "\",\"http\":{\"method\":\"";
+    out += METHODS.at(random.skewed(METHODS.size()));
+    out += "\",\"path\":\"/api/v1/resource/";
+    append_number(out, random.skewed(PATH_COUNT));
+    out += "\",\"status\":";
+    append_number(out, STATUSES.at(random.skewed(STATUSES.size())));
+    out += ",\"latency_ms\":";
+    append_number(out, random.skewed(30000));
+    out += "},\"tags\":[";
+    size_t tag_count = random.uniform(4);
+    for (size_t i = 0; i < tag_count; i++) {
+        out += i == 0 ? "\"t" : ",\"t";
+        append_number(out, random.skewed(256));
+        out += '"';
+    }
+    out += "],\"message\":\"request ";
+    append_hex(out, random.next());
+    out += " handled\"}";
+}
+
+// One NDJSON line of about `line_bytes`: an array of short strings and numbers
+void append_long_line(std::string& out, Random& random, uint64_t record_id, size_t line_bytes) {
+    size_t start = out.size();
+    out += "{\"id\":";
+    append_number(out, record_id);
+    out += ",\"payload\":[";
+    bool first = true;
+    while (out.size() - start < line_bytes) {
+        out += first ? "\"" : ",\"";
+        append_hex(out, random.next());
+        out += "\",";
+        append_number(out, random.uniform(1000000));
+        first = false;
+    }
+    out += "]}";
+}
+
+// Alternating objects and arrays, `depth` levels deep
+void append_deep_record(std::string& out, Random& random, uint64_t record_id, size_t depth) {
+    for (size_t level = 0; level < depth; level++) {
+        if (level % 2 == 0) {
+            out += "{\"level\":";
+            append_number(out, level);
+            out += ",\"value\":";
+            append_number(out, random.uniform(1000));
+            out += ",\"child\":";
+        } else {
+            out += "[";
+            append_number(out, record_id);
+            out += ",";
+        }
+    }
+    out += "null";
+    for (size_t level = depth; level-- > 0;) {
+        out += level % 2 == 0 ? "}" : "]";
+    }
+}
+
+// Generates block `block_index` of `block_count`, whole records until it holds at least
+// `target_bytes`; identical for identical arguments
+std::string generate_block(const Options& options, size_t block_index, size_t block_count,
+                           size_t target_bytes) {
+    Random random(options.seed ^ (0xD1B54A32D192ED03ULL * (block_index + 1)));
+    std::string out;
+    out.reserve(target_bytes + options.line_bytes + BLOCK_BYTES / 8);
+
+    // Record ids only need to be unique: derive them from the block index
+    uint64_t record_id = static_cast<uint64_t>(block_index) << 32;
+    bool huge = options.shape == Shape::Huge;
+    if (huge && block_index == 0) {
+        out += "{\"records\":[\n";
+    }
+    bool first = block_index == 0;
+    while (out.size() < target_bytes) {
+        switch (options.shape) {
+        case Shape::Log:
+            append_log_record(out, random, record_id);
+            break;
+        case Shape::Huge:
+            out += first ? "" : ",\n";
+            append_log_record(out, random, record_id);
+            break;
+        case Shape::LongLines:
+            append_long_line(out, random, record_id, options.line_bytes);
+            break;
+        case Shape::Deep:
+            append_deep_record(out, random, record_id, options.depth);
+            break;
+        }
+        if (!huge) {
+            out += '\n';
+        }
+        first = false;
+        record_id++;
+    }
+    if (huge && block_index + 1 == block_count) {
+        out += "\n]}\n";
+    }
+    return out;
+}
+
+// Compresses a block into a complete gzip member
+std::string gzip_member(const std::string& data, int level) {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEM_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+    std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END ? out : std::string();
+}
+
+// Plain or single-member gzip output
+class Sink {
+public:
+    Sink() = default;
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+    ~Sink() {
+        if (gzip_) {
+            deflateEnd(&stream_);
+        }
+        if (file_ != nullptr && file_ != stdout) {
+            std::fclose(file_);
+        }
+    }
+
+    bool open(const std::string& path, bool gzip, int level) {
+        file_ = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        if (gzip) {
+            if (deflateInit2(&stream_, level, Z_DEFLATED, GZIP_WINDOW_BITS, GZIP_MEM_LEVEL,
+                             Z_DEFAULT_STRATEGY) != Z_OK) {
+                return false;
+            }
+            gzip_ = true;
+            buffer_.resize(GZIP_OUT_BUFFER);
+        }
+        return true;
+    }
+
+    bool write(std::string_view data) {
+        bytes_in_ += data.size();
+        if (!gzip_) {
+            return write_raw(data);
+        }
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream_.avail_in = static_cast<uInt>(data.size());
+        return deflate_pending(Z_NO_FLUSH);
+    }
+
+    // Pre-compressed gzip members are written verbatim
+    bool write_compressed(std::string_view member, size_t uncompressed_bytes) {
+        bytes_in_ += uncompressed_bytes;
+        return write_raw(member);
+    }
+
+    bool finish() {
+        if (gzip_ && !deflate_pending(Z_FINISH)) {
+            return false;
+        }
+        return std::fflush(file_) == 0 && std::ferror(file_) == 0;
+    }
+
+    uint64_t bytes_in() const { return bytes_in_; }
+    uint64_t bytes_out() const { return bytes_out_; }
+
+private:
+    bool write_raw(std::string_view data) {
+        bytes_out_ += data.size();
+        return std::fwrite(data.data(), 1, data.size(), file_) == data.size();
+    }
+
+    bool deflate_pending(int flush) {
+        int result = Z_OK;
+        do {
+            stream_.next_out = reinterpret_cast<Bytef*>(buffer_.data());
+            stream_.avail_out = static_cast<uInt>(buffer_.size());
+            result = deflate(&stream_, flush);
+            if (result == Z_STREAM_ERROR ||
+                !write_raw({buffer_.data(), buffer_.size() - stream_.avail_out})) {
+                return false;
+            }
+        } while (stream_.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+        return true;
+    }
+
+    std::FILE* file_ = nullptr;
+    bool gzip_ = false;
+    z_stream stream_{};
+    std::vector<char> buffer_;
+    uint64_t bytes_in_ = 0;
+    uint64_t bytes_out_ = 0;
+};
+
+std::optional<uint64_t> parse_size(std::string_view text) {
+    uint64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end == text.data()) {
+        return std::nullopt;
+    }
+    std::string_view suffix(end, static_cast<size_t>(text.data() + text.size() - end));
+    if (suffix.empty()) {
+        return value;
+    }
+    if (suffix.size() != 1) {
+        return std::nullopt;
+    }
+    switch (suffix[0]) {
+    case 'K':
+    case 'k':
+        return value << 10;
+    case 'M':
+    case 'm':
+        return value << 20;
+    case 'G':
+    case 'g':
+        return value << 30;
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<Shape> parse_shape(std::string_view text) {
+    if (text == "log") {
+        return Shape::Log;
+    }
+    if (text == "huge") {
+        return Shape::Huge;
+    }
+    if (text == "long-lines") {
+        return Shape::LongLines;
+    }
+    if (text == "deep") {
+        return Shape::Deep;
+    }
+    return std::nullopt;
+}
+
+std::optional<Options> parse_args(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        std::optional<std::string_view> value;
+        if (i + 1 < argc) {
+            value = argv[i + 1];
+        }
+        if (arg == "--gzip") {
+            options.compression = Compression::Gzip;
+            continue;
+        }
+        if (arg == "--gzip-members") {
+            options.compression = Compression::GzipMembers;
+            continue;
+        }
+        if (!value) {
+            return std::nullopt;
+        }
+        i++;
+        if (arg == "--shape") {
+            std::optional<Shape> shape = parse_shape(*value);
+            if (!shape) {
+                return std::nullopt;
+            }
+            options.shape = *shape;
+            continue;
+        }
+        if (arg == "-o") {
+            options.output_path = *value;
+            continue;
+        }
+
+        std::optional<uint64_t> number = parse_size(*value);
+        if (!number) {
+            return std::nullopt;
+        }
+        if (arg == "--size") {
+            options.size = *number;
+        } else if (arg == "--seed") {
+            options.seed = *number;
+        } else if (arg == "--line-bytes") {
+            options.line_bytes = std::max<size_t>(1, *number);
+        } else if (arg == "--depth") {
+            options.depth = std::max<size_t>(1, *number);
+        } else if (arg == "--level" && *number <= 9) {
+            options.level = static_cast<int>(*number);
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (options.size == 0 || options.output_path.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::optional<Options> options = parse_args(argc, argv);
+    if (!options) {
+        std::fputs("usage: gen_data --shape log|huge|long-lines|deep --size SIZE [--seed N]\n"
+                   "                [--gzip | --gzip-members] [--level N] [--line-bytes SIZE]\n"
+                   "                [--depth N] -o PATH\n",
+                   stderr);
+        return 2;
+    }
+
+    Sink sink;
+    if (!sink.open(options->output_path, options->compression == Compression::Gzip,
+                   options->level)) {
+        std::fprintf(stderr, "error: cannot open %s\n", options->output_path.c_str());
+        return 1;
+    }
+
+    // A long line never spans blocks, so blocks grow to hold at least one
+    size_t block_bytes = options->shape == Shape::LongLines
+                             ? std::max(BLOCK_BYTES, options->line_bytes)
+                             : BLOCK_BYTES;
+    size_t block_count = static_cast<size_t>((options->size + block_bytes - 1) / block_bytes);
+    bool members = options->compression == Compression::GzipMembers;
+
+    struct Block {
+        std::string data;
+        size_t uncompressed_bytes = 0;
+    };
+    auto produce = [&options, block_count, block_bytes, members](size_t block_index) {
+        // The last block only fills what is left of --size
+        size_t target_bytes = static_cast<size_t>(
+            std::min<uint64_t>(block_bytes, options->size - block_index * block_bytes));
+        Block block;
+        block.data = generate_block(*options, block_index, block_count, target_bytes);
+        block.uncompressed_bytes = block.data.size();
+        if (members) {
+            block.data = gzip_member(block.data, options->level);
+        }
+        return block;
+    };
+
+    // Blocks are generated out of order on all cores and written strictly in order
+    auto start = std::chrono::steady_clock::now();
+    size_t max_in_flight = available_cpu_count() * BLOCKS_IN_FLIGHT_PER_CPU;
+    std::deque<std::future<Block>> in_flight;
+    size_t next_block = 0;
+    bool ok = true;
+    while (ok && (next_block < block_count || !in_flight.empty())) {
+        while (next_block < block_count && in_flight.size() < max_in_flight) {
+            in_flight.push_back(std::async(std::launch::async, produce, next_block++));
+        }
+        Block block = in_flight.front().get();
+        in_flight.pop_front();
+        ok = members ? !block.data.empty() &&
+                           sink.write_compressed(block.data, block.uncompressed_bytes)
+                     : sink.write(block.data);
+    }
+    ok = ok && sink.finish();
+    if (!ok) {
+        std::fprintf(stderr, "error: write to %s failed\n", options->output_path.c_str());
+        return 1;
+    }
+
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double megabytes = static_cast<double>(sink.bytes_in()) / BYTES_PER_MB;
+    std::fprintf(stderr, "%.1f MB generated (%.1f MB written) in %.2f s (%.1f MB/s)\n", megabytes,
+                 static_cast<double>(sink.bytes_out()) / BYTES_PER_MB, seconds,
+                 seconds > 0.0 ? megabytes / seconds : 0.0);
+    return 0;
+}